@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+using namespace std;
+
+#include "CompactRoster.hpp"
+#include "Company.hpp"
+#include "Manager.hpp"
+
+namespace company {
+
+CompactRoster::CompactRoster()
+{
+}
+
+CompactRoster::CompactRoster(const Company& company)
+{
+	int nEmployees = company.getNumberEmployees();
+	size_t nameBytes = 0;
+	for (int i = 0; i < nEmployees; i++) {
+		nameBytes += company.getEmployee(i)->Employee::getName().size() + 1;
+	}
+	reserve(nEmployees, nameBytes);
+
+	// The first manager of the company that manages an employee becomes its manager
+	unordered_map<Employee*, int> managerIndices;
+	for (int i = 0; i < nEmployees; i++) {
+		Employee* employee = company.getEmployee(i);
+		BasisPoints bonus = 0;
+		if (auto manager = dynamic_cast<Manager*>(employee)) {
+			bonus = manager->getBonusBasisPoints();
+			for (Employee* managed : manager->getManagedEmployees()) {
+				managerIndices.try_emplace(managed, i);
+			}
+		}
+		addEmployee(employee->Employee::getName(), employee->getRole(), employee->getBaseSalaryCents(), bonus);
+	}
+	if (!managerIndices.empty()) {
+		for (int i = 0; i < nEmployees; i++) {
+			auto found = managerIndices.find(company.getEmployee(i));
+			if (found != managerIndices.end()) {
+				setManager(i, found->second);
+			}
+		}
+	}
+}
+
+int CompactRoster::getNumberEmployees() const
+{
+	return int(records_.size());
+}
+
+string_view CompactRoster::getName(int index) const
+{
+	const char* name = names_.data() + records_[index].nameHandle;
+	return string_view(name, strlen(name));
+}
+
+Role CompactRoster::getRole(int index) const
+{
+	return Role(records_[index].role);
+}
+
+Cents CompactRoster::getBaseSalaryCents(int index) const
+{
+	return Cents(records_[index].baseSalary);
+}
+
+BasisPoints CompactRoster::getBonusBasisPoints(int index) const
+{
+	return BasisPoints(records_[index].bonus);
+}
+
+Cents CompactRoster::getSalaryCents(int index) const
+{
+	const Record& record = records_[index];
+	return addPercentage(Cents(record.baseSalary), BasisPoints(record.bonus));
+}
+
+int CompactRoster::getManagerIndex(int index) const
+{
+	uint32_t managerIndex = records_[index].managerIndex;
+	return managerIndex == noManager ? -1 : int(managerIndex);
+}
+
+Cents CompactRoster::getTotalSalaryCents() const
+{
+	Cents total = 0;
+	for (const Record& record : records_) {
+		total += addPercentage(Cents(record.baseSalary), BasisPoints(record.bonus));
+	}
+	return total;
+}
+
+size_t CompactRoster::memoryFootprint() const
+{
+	return sizeof(CompactRoster) + records_.capacity() * sizeof(Record) + names_.capacity() + 1;
+}
+
+size_t CompactRoster::estimateMemoryFootprint(size_t nEmployees, size_t nameBytes)
+{
+	return sizeof(CompactRoster) + nEmployees * sizeof(Record) + nameBytes + 1;
+}
+
+int CompactRoster::addEmployee(string_view name, Role role, Cents baseSalary, BasisPoints bonus)
+{
+	if (baseSalary < 0 || baseSalary > maxSalaryCents) {
+		throw out_of_range("Salary too large for a compact record");
+	}
+	if (bonus < 0 || bonus > maxBonus) {
+		throw out_of_range("Bonus too large for a compact record");
+	}
+	if (records_.size() >= size_t(maxEmployees) || names_.size() + name.size() >= UINT32_MAX) {
+		throw out_of_range("Compact roster full");
+	}
+
+	Record record;
+	record.nameHandle = uint32_t(names_.size());
+	record.managerIndex = noManager;
+	record.role = uint32_t(role);
+	record.baseSalary = uint64_t(baseSalary);
+	record.bonus = uint64_t(bonus);
+	names_.append(name);
+	names_.push_back('\0');
+	records_.push_back(record);
+	return int(records_.size()) - 1;
+}
+
+void CompactRoster::setManager(int index, int managerIndex)
+{
+	records_[index].managerIndex = managerIndex < 0 ? noManager : uint32_t(managerIndex);
+}
+
+void CompactRoster::reserve(size_t nEmployees, size_t nameBytes)
+{
+	records_.reserve(nEmployees);
+	names_.reserve(nameBytes);
+}
+
+void CompactRoster::clear()
+{
+	records_.clear();
+	names_.clear();
+}
+
+}
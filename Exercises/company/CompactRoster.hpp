@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+#include "Employee.hpp"
+#include "Money.hpp"
+
+
+namespace company {
+
+class Company;
+
+/**
+ * @brief The CompactRoster class, a read-mostly copy of a roster for bulk processing.
+ *
+ * An Employee is a polymorphic object allocated on its own, with a string, a list of observers
+ * and (for a Manager) a list and a hash table of managed employees: about 100 bytes and more, spread
+ * in memory. Here each employee is a 16 bytes record in a single vector (4 per cache line), and
+ * the names are stored one after the other in a single string, so a pass over all the salaries
+ * reads memory sequentially. The records are copies: they don't follow the changes of the
+ * employees they were made from.
+ */
+class CompactRoster
+{
+public:
+	/**
+	 * @brief maxSalaryCents The largest base salary a record can store (about 2.8 trillion dollars)
+	 */
+	static inline const Cents maxSalaryCents = (Cents(1) << 48) - 1;
+	/**
+	 * @brief maxBonus The largest bonus a record can store, in basis points (655.35%)
+	 */
+	static inline const BasisPoints maxBonus = 0xFFFF;
+	/**
+	 * @brief maxEmployees The largest number of records (an index must fit in 24 bits)
+	 */
+	static inline const int maxEmployees = 0xFF'FFFF;
+
+	// Constructors
+	/**
+	 * @brief CompactRoster The default constructor, without employees
+	 */
+	CompactRoster();
+	/**
+	 * @brief CompactRoster Constructor copying the employees of a company, in the same order.
+	 * An employee managed by a manager of the company gets the index of that manager.
+	 * @param company The company to copy
+	 */
+	explicit CompactRoster(const Company& company);
+
+	// Getters
+	/**
+	 * @brief getNumberEmployees To get the number of records
+	 * @return The number of employees
+	 */
+	int getNumberEmployees() const;
+	/**
+	 * @brief getName To get the name of an employee (without status)
+	 * @param index The index of the employee
+	 * @return The name, valid until the next employee is added
+	 */
+	string_view getName(int index) const;
+	/**
+	 * @brief getRole To get the kind of an employee
+	 * @param index The index of the employee
+	 * @return The role of the employee
+	 */
+	Role getRole(int index) const;
+	/**
+	 * @brief getBaseSalaryCents To get the salary of an employee before its bonus
+	 * @param index The index of the employee
+	 * @return The base salary in cents
+	 */
+	Cents getBaseSalaryCents(int index) const;
+	/**
+	 * @brief getBonusBasisPoints To get the bonus of an employee
+	 * @param index The index of the employee
+	 * @return The bonus in basis points (0 if it has none)
+	 */
+	BasisPoints getBonusBasisPoints(int index) const;
+	/**
+	 * @brief getSalaryCents To get the salary of an employee including its bonus, computed like Manager does
+	 * @param index The index of the employee
+	 * @return The salary in cents
+	 */
+	Cents getSalaryCents(int index) const;
+	/**
+	 * @brief getManagerIndex To get the manager of an employee
+	 * @param index The index of the employee
+	 * @return The index of its manager, or -1 if it has none
+	 */
+	int getManagerIndex(int index) const;
+	/**
+	 * @brief getTotalSalaryCents To get the sum of the salaries (including bonuses) of all the employees
+	 * @return The total in cents
+	 */
+	Cents getTotalSalaryCents() const;
+	/**
+	 * @brief memoryFootprint To get the memory used by the roster
+	 * @return The bytes of the object, of the records and of the names
+	 */
+	size_t memoryFootprint() const;
+	/**
+	 * @brief estimateMemoryFootprint To get the memory a roster reserved for some employees would use
+	 * @param nEmployees The number of employees
+	 * @param nameBytes The total length of their names, with one terminating byte each
+	 * @return The bytes of the object, of the records and of the names, as memoryFootprint() would say
+	 */
+	static size_t estimateMemoryFootprint(size_t nEmployees, size_t nameBytes);
+
+	// Setters
+	/**
+	 * @brief addEmployee To add a record at the end
+	 * @param name The name of the employee (without status)
+	 * @param role The kind of the employee
+	 * @param baseSalary The salary before the bonus, in cents (from 0 to maxSalaryCents)
+	 * @param bonus The bonus in basis points (from 0 to maxBonus)
+	 * @return The index of the new record
+	 * @throw out_of_range If the salary or the bonus can't be stored, or if the roster is full
+	 */
+	int addEmployee(string_view name, Role role, Cents baseSalary, BasisPoints bonus = 0);
+	/**
+	 * @brief setManager To set the manager of an employee
+	 * @param index The index of the employee
+	 * @param managerIndex The index of its manager, or -1 to remove it
+	 */
+	void setManager(int index, int managerIndex);
+	/**
+	 * @brief reserve To prepare for a number of employees without reallocating
+	 * @param nEmployees The number of employees
+	 * @param nameBytes The total length of their names
+	 */
+	void reserve(size_t nEmployees, size_t nameBytes);
+	/**
+	 * @brief clear To remove all the employees
+	 */
+	void clear();
+
+private:
+	/**
+	 * @brief The Record struct, an employee packed in 16 bytes
+	 */
+	struct Record {
+		uint32_t nameHandle;        // Offset of the name in names_
+		uint32_t managerIndex : 24; // Index of the manager, or noManager
+		uint32_t role : 8;
+		uint64_t baseSalary : 48;   // In cents
+		uint64_t bonus : 16;        // In basis points
+	};
+	static_assert(sizeof(Record) == 16, "A record must stay 16 bytes, 4 per cache line");
+
+	/**
+	 * @brief noManager The manager index of a record without manager
+	 */
+	static inline const uint32_t noManager = 0xFF'FFFF;
+
+	// Attributes
+	/**
+	 * @brief records_ To store the employees
+	 */
+	vector<Record> records_;
+	/**
+	 * @brief names_ To store the names, each followed by a '\0'
+	 */
+	string names_;
+};
+
+}
@@ -33,14 +33,75 @@
 
 #include <algorithm>
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
 using namespace std;
 
+#include <utils/LatencyHistogram.hpp>
+
 #include "Company.hpp"
+#include "CompactRoster.hpp"
+#include "DynamicSize.hpp"
 #include "SearchEmployeeByName.hpp"
 #include "InsertInMap.hpp"
 
 namespace company {
 
+namespace {
+
+/* Returns the incoming employees whose key is neither in the existing ones nor
+ * earlier in the incoming ones, in their order. The hash table is built on the
+ * smaller of the two lists and the other one is streamed through it.
+ */
+template <typename KeyOf>
+vector<Employee*> selectNewEmployees(const vector<Employee*>& existing, const vector<Employee*>& incoming, KeyOf keyOf)
+{
+	using Key = decltype(keyOf(nullptr));
+	vector<Employee*> selected;
+	selected.reserve(incoming.size());
+
+	if (existing.size() <= incoming.size()) {
+		// The incoming keys are added as they come, to skip their own duplicates
+		unordered_set<Key> seen;
+		seen.reserve(existing.size() + incoming.size());
+		for (Employee* employee : existing) {
+			seen.insert(keyOf(employee));
+		}
+		for (Employee* employee : incoming) {
+			if (seen.insert(keyOf(employee)).second) {
+				selected.push_back(employee);
+			}
+		}
+		return selected;
+	}
+
+	// First occurrence of each incoming key, then the existing employees mark the ones they already have
+	unordered_map<Key, bool> isAlreadyThere;
+	isAlreadyThere.reserve(incoming.size());
+	// Pointers to the elements of an unordered_map stay valid when it grows
+	vector<bool*> firstOccurrence(incoming.size(), nullptr);
+	for (size_t i = 0; i < incoming.size(); i++) {
+		auto [it, isNew] = isAlreadyThere.try_emplace(keyOf(incoming[i]), false);
+		if (isNew) {
+			firstOccurrence[i] = &it->second;
+		}
+	}
+	for (Employee* employee : existing) {
+		auto it = isAlreadyThere.find(keyOf(employee));
+		if (it != isAlreadyThere.end()) {
+			it->second = true;
+		}
+	}
+	for (size_t i = 0; i < incoming.size(); i++) {
+		if (firstOccurrence[i] != nullptr && !*firstOccurrence[i]) {
+			selected.push_back(incoming[i]);
+		}
+	}
+	return selected;
+}
+
+}
+
 bool Company::isValidName(const string& companyName) {
 	return companyName.find('@') != string::npos;
 }
@@ -48,19 +109,28 @@ bool Company::isValidName(const string& companyName) {
 Company::Company()
 	: name_("unknown"), president_(nullptr)
 {
+	setupPayroll();
 }
 
 Company::Company(string name, string presidentName)
 	: name_(name), president_(nullptr)
 {
 	president_ = new Employee(presidentName);
+	setupPayroll();
 }
 
 Company::Company(const Company& company)
     : QObject(), name_(company.name_),
-      president_(nullptr), employees_(company.employees_)
+      president_(nullptr), employees_(company.employees_),
+      rosterFingerprint_(company.rosterFingerprint_),
+      orderedFingerprint_(company.orderedFingerprint_),
+      isOrderedFingerprintValid_(company.isOrderedFingerprintValid_)
 {
 	president_ = new Employee(*(company.president_));
+	setupPayroll();
+	for (Employee* employee : employees_) {
+		payroll_.track(employee);
+	}
 }
 
 Company::~Company()
@@ -82,6 +152,7 @@ void Company::setPresident(Employee* president)
 {
 	delete president_;
 	president_ = new Employee(president->getName());
+	emit presidentChanged(president_);
 }
 
 int Company::getNumberEmployees() const
@@ -96,6 +167,7 @@ bool Company::hasEmployees() const
 
 Employee* Company::getEmployee(unsigned int index) const
 {
+	UTILS_MEASURE_LATENCY("Company::getEmployee(index)");
 	if (index >= 0 && index < employees_.size()) {
 		return employees_[index];
 	}
@@ -108,6 +180,7 @@ Employee* Company::getEmployee(unsigned int index) const
 
 Employee* Company::getEmployee(string name) const
 {
+	UTILS_MEASURE_LATENCY("Company::getEmployee(name)");
 	SearchEmployeeByName search(name);
 
 	//auto => vector<Employee*>::const_iterator
@@ -124,23 +197,247 @@ Employee* Company::getEmployee(string name) const
 
 void Company::addEmployee(Employee* employee)
 {
+	UTILS_MEASURE_LATENCY("Company::addEmployee");
 	// Insert new employee
 	employees_.push_back(employee);
+	fingerprintAdded(employee);
+	payroll_.track(employee);
+	publishSnapshot();
     emit employeeAdded(employee);
 }
 
 void Company::delEmployee(Employee* employee)
 {
+	UTILS_MEASURE_LATENCY("Company::delEmployee");
 	// auto => vector<Employee*>::iterator
 	auto it = find(employees_.begin(), employees_.end(), employee);
 
 	if (it != employees_.end()) {
         Employee* e = *it;
+		fingerprintDeleted(it - employees_.begin());
 		employees_.erase(it);
+		payroll_.untrack(e);
+		publishSnapshot();
         emit employeeDeleted(e);
 	}
 }
 
+int Company::merge(const Company& company, DuplicatePolicy policy)
+{
+	UTILS_MEASURE_LATENCY("Company::merge");
+	vector<Employee*> added;
+	switch (policy) {
+	case DuplicatePolicy::keepAll:
+		added = company.employees_;
+		break;
+	case DuplicatePolicy::skipSameEmployee:
+		added = selectNewEmployees(employees_, company.employees_, [](Employee* employee) { return employee; });
+		break;
+	case DuplicatePolicy::skipSameName:
+		added = selectNewEmployees(employees_, company.employees_, [](Employee* employee) { return employee->getName(); });
+		break;
+	}
+	if (added.empty()) {
+		return 0;
+	}
+
+	int firstIndex = int(employees_.size());
+	size_t newSize = employees_.size() + added.size();
+	employees_.reserve(newSize);
+	payroll_.reserve(newSize);
+	for (Employee* employee : added) {
+		employees_.push_back(employee);
+		fingerprintAdded(employee);
+		payroll_.track(employee);
+	}
+	publishSnapshot();
+	emit employeesMerged(firstIndex, int(added.size()));
+	return int(added.size());
+}
+
+Cents Company::getTotalSalaryCents() const
+{
+	return payroll_.getTotalSalaryCents();
+}
+
+const PayrollTracker& Company::getPayroll() const
+{
+	return payroll_;
+}
+
+double Company::MemoryFootprint::getBytesPerEmployee() const
+{
+	return nEmployees == 0 ? 0 : double(companyBytes + employeesBytes) / nEmployees;
+}
+
+double Company::MemoryFootprint::getCompactBytesPerEmployee() const
+{
+	return nEmployees == 0 ? 0 : double(compactBytes) / nEmployees;
+}
+
+Company::MemoryFootprint Company::memoryFootprint() const
+{
+	MemoryFootprint footprint;
+	footprint.nEmployees = getNumberEmployees();
+	// The payroll tracker is inside the company, so only what it allocated is added
+	footprint.companyBytes = sizeof(Company) + dynamicSize(name_) + dynamicSize(employees_)
+	                       + (payroll_.memoryFootprint() - sizeof(PayrollTracker));
+	auto addSnapshotBytes = [&footprint] (const RosterSnapshot& handle) {
+		// make_shared puts the vector and the counters (about 16 bytes) in a single block
+		footprint.companyBytes += sizeof(handle) + sizeof(*handle) + 16 + dynamicSize(*handle);
+	};
+	if (snapshotHandle_ != nullptr) {
+		addSnapshotBytes(*snapshotHandle_);
+	}
+	for (const RetiredSnapshot& retired : retiredSnapshots_) {
+		addSnapshotBytes(*retired.handle);
+	}
+
+	unordered_set<Employee*> counted;
+	counted.reserve(employees_.size());
+	// A CompactRoster has a record and a copy of the name for each entry, even a repeated one
+	size_t nameBytes = 0;
+	for (Employee* employee : employees_) {
+		if (counted.insert(employee).second) {
+			footprint.employeesBytes += employee->memoryFootprint();
+		}
+		nameBytes += employee->Employee::getName().size() + 1;
+	}
+	footprint.compactBytes = CompactRoster::estimateMemoryFootprint(employees_.size(), nameBytes);
+	return footprint;
+}
+
+void Company::setupPayroll()
+{
+	payroll_.setSalaryChangedCallback([this](Employee* employee) {
+		emit employeeSalaryChanged(employee);
+	});
+	/* The pointers to a destroyed employee are removed without employeeDeleted: its
+	 * receivers could be in the middle of their own destruction (like a window
+	 * destroying the employees it created)
+	 */
+	payroll_.setDestroyedCallback([this](Employee* employee) {
+		for (size_t i = employees_.size(); i-- > 0;) {
+			if (employees_[i] == employee) {
+				fingerprintDeleted(i);
+			}
+		}
+		erase(employees_, employee);
+		publishSnapshot();
+		emit employeeDestroyed(employee);
+	});
+}
+
+Fingerprint Company::getRosterFingerprint() const
+{
+	return rosterFingerprint_;
+}
+
+Fingerprint Company::getOrderedRosterFingerprint() const
+{
+	if (!isOrderedFingerprintValid_) {
+		orderedFingerprint_ = Fingerprint();
+		for (size_t i = 0; i < employees_.size(); i++) {
+			orderedFingerprint_ += Fingerprint::of(employees_[i], i);
+		}
+		isOrderedFingerprintValid_ = true;
+	}
+	return orderedFingerprint_;
+}
+
+void Company::fingerprintAdded(Employee* employee)
+{
+	rosterFingerprint_ += Fingerprint::of(employee);
+	// Each employee is salted with its position, so the sum depends on the order
+	orderedFingerprint_ += Fingerprint::of(employee, employees_.size() - 1);
+}
+
+void Company::fingerprintDeleted(size_t index)
+{
+	Employee* employee = employees_[index];
+	rosterFingerprint_ -= Fingerprint::of(employee);
+	if (index + 1 == employees_.size()) {
+		orderedFingerprint_ -= Fingerprint::of(employee, index);
+	} else {
+		// The employees after it move, so all their salts would change
+		isOrderedFingerprintValid_ = false;
+	}
+}
+
+Company::RosterSnapshot Company::getSnapshot() const
+{
+	/* We count ourselves as a reader of the current generation, checking that it didn't
+	 * change in the meantime (it only changes at a publication), so that reclaimSnapshots
+	 * knows which handles we may reach while we copy one
+	 */
+	uint64_t generation;
+	while (true) {
+		generation = snapshotGeneration_.load();
+		nSnapshotReaders_[generation & 1].fetch_add(1);
+		if (snapshotGeneration_.load() == generation) {
+			break;
+		}
+		nSnapshotReaders_[generation & 1].fetch_sub(1);
+	}
+	const RosterSnapshot* handle = snapshot_.load();
+	RosterSnapshot snapshot = handle != nullptr ? *handle : nullptr;
+	nSnapshotReaders_[generation & 1].fetch_sub(1);
+	if (snapshot == nullptr) {
+		static const RosterSnapshot emptyRoster = make_shared<const vector<Employee*>>();
+		return emptyRoster;
+	}
+	return snapshot;
+}
+
+bool Company::areSnapshotsEnabled() const
+{
+	return snapshotsEnabled_;
+}
+
+void Company::setSnapshotsEnabled(bool enabled)
+{
+	snapshotsEnabled_ = enabled;
+	// Publish the current state right away so readers don't see an outdated version
+	publishSnapshot();
+}
+
+void Company::publishSnapshot()
+{
+	if (!snapshotsEnabled_)
+		return;
+	/* Readers still holding the previous version keep it alive,
+	 * it is freed when the last of them releases it
+	 */
+	auto handle = make_unique<const RosterSnapshot>(make_shared<const vector<Employee*>>(employees_));
+	snapshot_.store(handle.get());
+	if (snapshotHandle_ != nullptr) {
+		retiredSnapshots_.push_back({snapshotGeneration_.load(), move(snapshotHandle_)});
+	}
+	snapshotHandle_ = move(handle);
+	reclaimSnapshots();
+}
+
+void Company::reclaimSnapshots()
+{
+	/* A reader counts itself under the generation it started in. Once no reader of the
+	 * previous generation is left, every reader in progress started in the current one,
+	 * after the handles retired in earlier generations were replaced: those can be freed.
+	 * We then start a new generation, at most twice, so that without readers even the
+	 * handle retired by this publication is freed. With readers, we don't wait: a reader
+	 * is only counted while it copies a shared_ptr, so the next publication will succeed.
+	 */
+	for (int i = 0; i < 2; i++) {
+		uint64_t generation = snapshotGeneration_.load();
+		if (nSnapshotReaders_[(generation - 1) & 1].load() != 0) {
+			return;
+		}
+		snapshotGeneration_.store(generation + 1);
+		auto firstKept = find_if(retiredSnapshots_.begin(), retiredSnapshots_.end(),
+		                         [generation] (const RetiredSnapshot& retired) { return retired.generation >= generation; });
+		retiredSnapshots_.erase(retiredSnapshots_.begin(), firstKept);
+	}
+}
+
 // Overcharged operators
 Company& Company::operator=(const Company& company)
 {
@@ -150,12 +447,30 @@ Company& Company::operator=(const Company& company)
 		president_ = new Employee(*(company.president_));
 		name_ = company.name_;
 		employees_ = company.employees_;
+		rosterFingerprint_ = company.rosterFingerprint_;
+		orderedFingerprint_ = company.orderedFingerprint_;
+		isOrderedFingerprintValid_ = company.isOrderedFingerprintValid_;
+		payroll_.clear();
+		for (Employee* employee : employees_) {
+			payroll_.track(employee);
+		}
+		publishSnapshot();
+		emit rosterReplaced();
 	}
 	return *this;
 }
 
 bool Company::operator==(const Company& company) const
 {
+	// Different fingerprints can only come from different rosters, but equal ones must still be checked
+	if (employees_.size() != company.employees_.size() ||
+	    rosterFingerprint_ != company.rosterFingerprint_) {
+		return false;
+	}
+	if (isOrderedFingerprintValid_ && company.isOrderedFingerprintValid_ &&
+	    orderedFingerprint_ != company.orderedFingerprint_) {
+		return false;
+	}
 	return (name_ == company.name_ &&
 		president_ == company.president_ &&
 		employees_ == company.employees_);
@@ -195,39 +510,36 @@ Company Company::operator+(Employee& employee) const
 
 Company& Company::operator+=(const Company& company)
 {
-	for (int i = 0; i < company.getNumberEmployees(); i++) {
-		addEmployee(company.getEmployee(i));
-	}
+	merge(company, DuplicatePolicy::keepAll);
 	return *this;
 }
 
 Company Company::operator+(const Company& company) const
 {
 	Company c2(name_ + " " + company.name_, president_->getName());
-	for (int i = 0; i < getNumberEmployees(); i++) {
-		c2.addEmployee(getEmployee(i));
-	}
-	for (int i = 0; i < company.getNumberEmployees(); i++) {
-		c2.addEmployee(company.getEmployee(i));
-	}
+	c2.merge(*this, DuplicatePolicy::keepAll);
+	c2.merge(company, DuplicatePolicy::keepAll);
 	return c2;
 }
 
 ostream& operator<<(ostream& os, const Company& company)
 {
+	// '\n' rather than endl, so the stream isn't flushed for every line (see CompanyReportWriter for big dumps)
 	os << "This is the company " << company.getName()
 	   << " presided by " << company.getPresident()->getName()
-	   << endl;
+	   << '\n';
 	if (company.hasEmployees()) {
 		os << "This company has "
 		   << company.getNumberEmployees()
 		   << " employee(s): ";
-		for (int i = 0; i < company.getNumberEmployees(); i++)
-			os << endl
+		for (int i = 0; i < company.getNumberEmployees(); i++) {
+			Employee* employee = company.getEmployee(i);
+			os << '\n'
 			   << " - Employee " << i << ": "
-			   << company.getEmployee(i)->getName()
+			   << employee->getName()
 			   << ", paid $"
-			   << company.getEmployee(i)->getSalary();
+			   << employee->getSalary();
+		}
 	} else {
 		os << "This company does not have any employees.";
 	}
@@ -33,15 +33,20 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
+#include <atomic>
 #include <iostream>
 using namespace std;
 
 #include <QObject>
 
 #include "Employee.hpp"
+#include "Fingerprint.hpp"
+#include "PayrollTracker.hpp"
 
 
 namespace company {
@@ -54,6 +59,39 @@ class Company : public QObject
     Q_OBJECT
 
 public:
+	/**
+	 * @brief RosterSnapshot An immutable version of the employees list, shared by its readers
+	 */
+	using RosterSnapshot = shared_ptr<const vector<Employee*>>;
+	/**
+	 * @brief DuplicatePolicy What merge does with an employee already in the company
+	 */
+	enum class DuplicatePolicy {
+		keepAll,          // Added anyway, like operator+=
+		skipSameEmployee, // Skipped if the same Employee object is already there
+		skipSameName      // Skipped if an employee of the same name (getName) is already there
+	};
+	/**
+	 * @brief The MemoryFootprint struct, the estimated memory used by a company and its employees
+	 */
+	struct MemoryFootprint {
+		int    nEmployees = 0;     // Number of employees, an employee added twice counts twice
+		size_t companyBytes = 0;   // The company, its list of employees, its payroll totals and its snapshot
+		size_t employeesBytes = 0; // The employee objects and what they allocated (each counted once)
+		size_t compactBytes = 0;   // The same roster stored as a CompactRoster
+
+		/**
+		 * @brief getBytesPerEmployee To get the memory used per employee
+		 * @return (companyBytes + employeesBytes) / nEmployees, or 0 without employees
+		 */
+		double getBytesPerEmployee() const;
+		/**
+		 * @brief getCompactBytesPerEmployee To get the memory used per employee by a CompactRoster
+		 * @return compactBytes / nEmployees, or 0 without employees
+		 */
+		double getCompactBytesPerEmployee() const;
+	};
+
 	static inline const int maxEmployees = 100'000;
 	static bool isValidName(const string& companyName);
 
@@ -121,6 +159,54 @@ public:
 	 * @return A multimap of employees with keys as their names
 	 */
 	multimap<string, Employee*> getEmployeesPerName() const;
+	/**
+	 * @brief getTotalSalaryCents To get the sum of the salaries of all the employees.
+	 * The total is kept up to date on each change (in exact integer cents), so this is O(1).
+	 * @return The total of the salaries, in cents
+	 */
+	Cents getTotalSalaryCents() const;
+	/**
+	 * @brief getPayroll To get the running payroll totals (count, total and sum of squares of
+	 * the salaries, per role and overall), updated in O(1) on each addition, deletion,
+	 * salary change or bonus change
+	 * @return The payroll totals of the company
+	 */
+	const PayrollTracker& getPayroll() const;
+	/**
+	 * @brief getRosterFingerprint To get the fingerprint of the employees, whatever their order.
+	 * It is kept up to date on each addition and deletion, so this is O(1). Like operator==, it
+	 * depends on which Employee objects are in the company (their address), so it only identifies
+	 * a roster during one execution, for example as the key of a cache.
+	 * @return The fingerprint of the employees (as a multiset)
+	 */
+	Fingerprint getRosterFingerprint() const;
+	/**
+	 * @brief getOrderedRosterFingerprint To get the fingerprint of the employees, in their order.
+	 * It is kept up to date when employees are added at the end (or the last one is deleted) and
+	 * recomputed in O(n) on the first call after another deletion.
+	 * @return The fingerprint of the sequence of employees
+	 */
+	Fingerprint getOrderedRosterFingerprint() const;
+	/**
+	 * @brief getSnapshot To get the last published version of the employees list.
+	 * Can be called from any thread, even while the owning thread adds or deletes employees.
+	 * It takes no lock: it only copies the shared_ptr of the published version, so it never
+	 * waits for the owning thread (and the owning thread never waits for it).
+	 * The returned version never changes and is freed when its last reader releases it.
+	 * @return The last published roster (empty if snapshots were never enabled)
+	 */
+	RosterSnapshot getSnapshot() const;
+	/**
+	 * @brief memoryFootprint To estimate the memory used by the company and its employees,
+	 * compared with what a CompactRoster of the same employees would use
+	 * @return The estimated bytes, without the bookkeeping of the allocator
+	 */
+	MemoryFootprint memoryFootprint() const;
+	/**
+	 * @brief areSnapshotsEnabled To know if a snapshot is published after each change
+	 * @return Whether or not snapshots are published
+	 */
+	bool areSnapshotsEnabled() const;
 
 	// Setters
 	/**
@@ -129,10 +215,27 @@ public:
 	 */
 	void addEmployee(Employee* employee);
 	/**
-	 * @brief delEmployee To delete an employee to the company
+	 * @brief delEmployee To delete an employee to the company. An employee destroyed while still
+	 * in the company is removed from it automatically (with employeeDestroyed, not employeeDeleted).
 	 * @param employee The employee to delete
 	 */
 	void delEmployee(Employee* employee);
+	/**
+	 * @brief merge To add the employees of another company at the end of ours, in their order.
+	 * The duplicates (with ours and among theirs) are found with a hash table built on the smaller
+	 * roster, the other one is streamed through it, so the merge is linear. The employees are added
+	 * after a single reservation and announced by a single employeesMerged signal.
+	 * @param company The company from which to add the employees (can be ours)
+	 * @param policy What to do with the employees already in the company
+	 * @return The number of employees added
+	 */
+	int merge(const Company& company, DuplicatePolicy policy = DuplicatePolicy::skipSameEmployee);
+	/**
+	 * @brief setSnapshotsEnabled To publish (or not) a new roster snapshot after each change.
+	 * Each publication copies the employees list, so it is disabled by default.
+	 * @param enabled Whether or not snapshots should be published
+	 */
+	void setSnapshotsEnabled(bool enabled);
 
 	// Overcharged operators
 	/**
@@ -141,7 +244,8 @@ public:
 	 */
 	Company& operator=(const Company& company);
 	/**
-	 * @brief operator== To verify if a company is the same as another
+	 * @brief operator== To verify if a company is the same as another. Companies whose roster
+	 * fingerprints differ are different, so the employees are only compared one by one if they match.
 	 * @param company the company to which we compare ours
 	 */
 	bool operator==(const Company& company) const;
@@ -166,7 +270,7 @@ public:
 	 */
 	Company operator+(Employee& employee) const;
 	/**
-	 * @brief operator+= To add all the employees of the given company to ours
+	 * @brief operator+= To add all the employees of the given company to ours (see merge)
 	 * @param company The company from which to copy all the employees
 	 */
 	Company& operator+=(const Company& company);
@@ -194,6 +298,35 @@ signals:
      * @param employee The employee that has been deleted
      */
     void employeeDeleted(Employee* employee);
+    /**
+     * @brief employeeSalaryChanged Signal sent when the salary of an employee changed (its base
+     * salary, or its bonus), after the payroll totals were updated
+     * @param employee The employee whose salary changed
+     */
+    void employeeSalaryChanged(Employee* employee);
+    /**
+     * @brief presidentChanged Signal sent when the company got a new president
+     * @param president The new president (owned by the company)
+     */
+    void presidentChanged(Employee* president);
+    /**
+     * @brief employeesMerged Signal sent once after merge added employees, instead of one employeeAdded each
+     * @param firstIndex The index of the first added employee
+     * @param count The number of added employees (they are at the end of the list)
+     */
+    void employeesMerged(int firstIndex, int count);
+    /**
+     * @brief employeeDestroyed Signal sent when an employee being destroyed was removed from the
+     * company (all its occurrences). The employee is in its destructor: only its address and
+     * Employee::getName() can still be used.
+     * @param employee The employee being destroyed
+     */
+    void employeeDestroyed(Employee* employee);
+    /**
+     * @brief rosterReplaced Signal sent when an assignment (operator=) replaced the name, the
+     * president and all the employees, instead of a signal for each change
+     */
+    void rosterReplaced();
 
 private:
 	// Attributes
@@ -209,6 +342,76 @@ private:
 	 * @brief employees_ To store the employees of the company
 	 */
 	vector<Employee*> employees_;
+	/**
+	 * @brief payroll_ To store the running payroll totals, it observes the employees
+	 */
+	PayrollTracker payroll_;
+	/**
+	 * @brief rosterFingerprint_ To store the fingerprint of the employees, whatever their order
+	 */
+	Fingerprint rosterFingerprint_;
+	/**
+	 * @brief orderedFingerprint_ To store the fingerprint of the sequence of employees, when isOrderedFingerprintValid_
+	 */
+	mutable Fingerprint orderedFingerprint_;
+	/**
+	 * @brief isOrderedFingerprintValid_ To know if orderedFingerprint_ is up to date, or must be recomputed
+	 */
+	mutable bool isOrderedFingerprintValid_ = true;
+	/**
+	 * @brief snapshotsEnabled_ To know if snapshots are published after each change
+	 */
+	bool snapshotsEnabled_ = false;
+	/**
+	 * @brief snapshot_ To point to the handle of the last published roster, read atomically by other threads.
+	 * atomic<shared_ptr> is not lock-free with the usual standard libraries, hence the raw pointer.
+	 */
+	atomic<const RosterSnapshot*> snapshot_ = nullptr;
+	/**
+	 * @brief RetiredSnapshot A handle replaced by a newer one, which a reader may still be copying
+	 */
+	struct RetiredSnapshot {
+		uint64_t                         generation; // The value of snapshotGeneration_ when it was replaced
+		unique_ptr<const RosterSnapshot> handle;
+	};
+	/**
+	 * @brief snapshotHandle_ To own the published handle
+	 */
+	unique_ptr<const RosterSnapshot> snapshotHandle_;
+	/**
+	 * @brief retiredSnapshots_ To own the replaced handles until no reader can reach them, oldest first
+	 */
+	vector<RetiredSnapshot> retiredSnapshots_;
+	/**
+	 * @brief snapshotGeneration_ To number the reading periods, see reclaimSnapshots
+	 */
+	atomic<uint64_t> snapshotGeneration_ = 0;
+	/**
+	 * @brief nSnapshotReaders_ To count the getSnapshot calls in progress, by parity of the generation they started in
+	 */
+	mutable array<atomic<int>, 2> nSnapshotReaders_ = {};
+
+	/**
+	 * @brief publishSnapshot To publish a copy of the current employees list, if enabled
+	 */
+	void publishSnapshot();
+	/**
+	 * @brief reclaimSnapshots To free the retired handles that no reader can reach anymore, without waiting for the readers
+	 */
+	void reclaimSnapshots();
+	/**
+	 * @brief setupPayroll To react to the salary changes and destruction of the employees
+	 */
+	void setupPayroll();
+	/**
+	 * @brief fingerprintAdded To update the fingerprints after an employee was added at the end
+	 */
+	void fingerprintAdded(Employee* employee);
+	/**
+	 * @brief fingerprintDeleted To update the fingerprints before an employee is deleted
+	 * @param index The position of the employee being deleted
+	 */
+	void fingerprintDeleted(size_t index);
 };
 
 
@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#include <algorithm>
+#include <functional>
+using namespace std;
+
+#include "CompanyIndex.hpp"
+#include "RosterSubscription.hpp"
+
+namespace company {
+
+namespace {
+
+/**
+ * @brief isSalaryRestricted To know if a query has a salary predicate
+ */
+bool isSalaryRestricted(const CompanyIndex::Query& query)
+{
+	return query.minSalary != numeric_limits<Cents>::min() || query.maxSalary != numeric_limits<Cents>::max();
+}
+
+/**
+ * @brief startsWith To know if a name starts with a prefix
+ */
+bool startsWith(const string& name, const string& prefix)
+{
+	return name.compare(0, prefix.size(), prefix) == 0;
+}
+
+}
+
+CompanyIndex::CompanyIndex(Company* company)
+	: company_(company)
+{
+	rebuild();
+	connectRoster(company, this, {
+		.added = [this](Employee* employee) { add(employee); },
+		.deleted = [this](Employee* employee) { remove(employee, false); },
+		// The employee is in its destructor, where Employee::getName() is still valid
+		.destroyed = [this](Employee* employee) { remove(employee, true); },
+		.salaryChanged = [this](Employee* employee) { updateSalary(employee); },
+		.replaced = [this]() { rebuild(); },
+	});
+}
+
+vector<Employee*> CompanyIndex::find(const Query& query) const
+{
+	vector<Match> results = collect(query);
+	vector<Employee*> found;
+	found.reserve(results.size());
+	for (auto&& [employee, entry] : results) {
+		found.push_back(employee);
+	}
+	return found;
+}
+
+vector<CompanyIndex::Group> CompanyIndex::group(const Query& query, GroupKey key) const
+{
+	vector<Match> results = collect(query);
+
+	// The manager of each employee, from the managers of the company
+	unordered_map<const Employee*, Manager*> managers;
+	if (key == GroupKey::manager) {
+		for (auto&& [salary, employee] : salaries_[int(Role::manager)]) {
+			if (auto manager = dynamic_cast<Manager*>(employee)) {
+				for (Employee* managed : manager->getManagedEmployees()) {
+					managers.try_emplace(managed, manager);
+				}
+			}
+		}
+	}
+
+	vector<Group> groups;
+	unordered_map<const void*, size_t> groupIndices;
+	for (auto&& [employee, entry] : results) {
+		Group group;
+		const void* groupId;
+		if (key == GroupKey::role) {
+			// A role is identified by the address of its salary index
+			group.role = entry->role;
+			groupId = &salaries_[int(entry->role)];
+		} else {
+			auto found = managers.find(employee);
+			group.manager = found != managers.end() ? found->second : nullptr;
+			groupId = group.manager;
+		}
+		auto [it, isNew] = groupIndices.try_emplace(groupId, groups.size());
+		if (isNew) {
+			groups.push_back(move(group));
+		}
+		Group& current = groups[it->second];
+		current.employees.push_back(employee);
+		current.totalSalary += entry->salary->first;
+	}
+	return groups;
+}
+
+CompanyIndex::AccessPath CompanyIndex::choosePath(const Query& query) const
+{
+	return makePlan(query).path;
+}
+
+void CompanyIndex::rebuild()
+{
+	entries_.clear();
+	for (SalaryIndex& salaries : salaries_) {
+		salaries.clear();
+	}
+	names_.clear();
+	entries_.reserve(company_->getNumberEmployees());
+	for (int i = 0; i < company_->getNumberEmployees(); i++) {
+		add(company_->getEmployee(i));
+	}
+}
+
+CompanyIndex::Plan CompanyIndex::makePlan(const Query& query) const
+{
+	Plan plan;
+	plan.cost = entries_.size();
+	if (query.manager != nullptr) {
+		const vector<Employee*>& managed = query.manager->getManagedEmployees();
+		plan.managed.insert(managed.begin(), managed.end());
+		if (plan.managed.size() < plan.cost) {
+			plan.path = AccessPath::manager;
+			plan.cost = plan.managed.size();
+		}
+	}
+	if (query.role && salaries_[int(*query.role)].size() < plan.cost) {
+		plan.path = AccessPath::role;
+		plan.cost = salaries_[int(*query.role)].size();
+	}
+
+	/* The ranges are counted only up to the best cost so far: counting further
+	 * would cost more than scanning the index already chosen
+	 */
+	if (isSalaryRestricted(query) && query.minSalary <= query.maxSalary) {
+		size_t count = 0;
+		for (int role = 0; role < numberRoles; role++) {
+			if (query.role && int(*query.role) != role) {
+				continue;
+			}
+			const SalaryIndex& salaries = salaries_[role];
+			auto last = salaries.upper_bound(query.maxSalary);
+			for (auto it = salaries.lower_bound(query.minSalary); it != last && count <= plan.cost; ++it) {
+				count++;
+			}
+		}
+		if (count <= plan.cost) {
+			plan.path = AccessPath::salaryRange;
+			plan.cost = count;
+		}
+	}
+	if (!query.namePrefix.empty()) {
+		size_t count = 0;
+		for (auto it = names_.lower_bound(query.namePrefix); it != names_.end() && startsWith(it->first, query.namePrefix) && count <= plan.cost; ++it) {
+			count++;
+		}
+		if (count <= plan.cost) {
+			plan.path = AccessPath::namePrefix;
+			plan.cost = count;
+		}
+	}
+	return plan;
+}
+
+template <typename Fn>
+void CompanyIndex::scan(const Query& query, const Plan& plan, Fn&& fn) const
+{
+	auto visit = [&](Employee* employee) {
+		auto found = entries_.find(employee);
+		if (found != entries_.end() && matches(query, plan, employee, found->second)) {
+			fn(employee, found->second);
+		}
+	};
+
+	switch (plan.path) {
+	case AccessPath::fullScan:
+		for (auto&& [employee, entry] : entries_) {
+			if (matches(query, plan, employee, entry)) {
+				fn(employee, entry);
+			}
+		}
+		break;
+	case AccessPath::role:
+		for (auto&& [salary, employee] : salaries_[int(*query.role)]) {
+			visit(employee);
+		}
+		break;
+	case AccessPath::salaryRange:
+		for (int role = 0; role < numberRoles; role++) {
+			if (query.role && int(*query.role) != role) {
+				continue;
+			}
+			const SalaryIndex& salaries = salaries_[role];
+			auto last = salaries.upper_bound(query.maxSalary);
+			for (auto it = salaries.lower_bound(query.minSalary); it != last; ++it) {
+				visit(it->second);
+			}
+		}
+		break;
+	case AccessPath::namePrefix:
+		for (auto it = names_.lower_bound(query.namePrefix); it != names_.end() && startsWith(it->first, query.namePrefix); ++it) {
+			visit(it->second);
+		}
+		break;
+	case AccessPath::manager:
+		for (const Employee* employee : plan.managed) {
+			visit(const_cast<Employee*>(employee));
+		}
+		break;
+	}
+}
+
+vector<CompanyIndex::Match> CompanyIndex::collect(const Query& query) const
+{
+	Plan plan = makePlan(query);
+	vector<Match> results;
+	scan(query, plan, [&](Employee* employee, const Entry& entry) {
+		results.insert(results.end(), entry.count, Match(employee, &entry));
+	});
+
+	// A range of a single salary index is already sorted by salary, and a name prefix by name
+	bool isSorted = (query.sortKey == SortKey::salary && plan.path == AccessPath::salaryRange && query.role)
+	             || (query.sortKey == SortKey::salary && plan.path == AccessPath::role)
+	             || (query.sortKey == SortKey::name && plan.path == AccessPath::namePrefix);
+	if (isSorted) {
+		if (query.isDescending) {
+			reverse(results.begin(), results.end());
+		}
+		return results;
+	}
+
+	auto sortBy = [&](auto key) {
+		if (query.isDescending) {
+			stable_sort(results.begin(), results.end(), [&](const Match& a, const Match& b) { return key(b) < key(a); });
+		} else {
+			stable_sort(results.begin(), results.end(), [&](const Match& a, const Match& b) { return key(a) < key(b); });
+		}
+	};
+	switch (query.sortKey) {
+	case SortKey::none:
+		break;
+	case SortKey::name:
+		sortBy([](const Match& match) -> const string& { return match.second->name->first; });
+		break;
+	case SortKey::salary:
+		sortBy([](const Match& match) { return match.second->salary->first; });
+		break;
+	case SortKey::role:
+		sortBy([](const Match& match) { return match.second->role; });
+		break;
+	}
+	return results;
+}
+
+bool CompanyIndex::matches(const Query& query, const Plan& plan, const Employee* employee, const Entry& entry)
+{
+	Cents salary = entry.salary->first;
+	return (!query.role || entry.role == *query.role)
+	    && salary >= query.minSalary && salary <= query.maxSalary
+	    && startsWith(entry.name->first, query.namePrefix)
+	    && (query.manager == nullptr || plan.managed.contains(employee));
+}
+
+void CompanyIndex::add(Employee* employee)
+{
+	auto [it, isNew] = entries_.try_emplace(employee);
+	Entry& entry = it->second;
+	if (isNew) {
+		entry.role = employee->getRole();
+		entry.count = 0;
+		entry.salary = salaries_[int(entry.role)].emplace(employee->getSalaryCents(), employee);
+		entry.name = names_.emplace(employee->Employee::getName(), employee);
+	}
+	entry.count++;
+}
+
+void CompanyIndex::remove(Employee* employee, bool isAllRemoved)
+{
+	auto found = entries_.find(employee);
+	if (found == entries_.end()) {
+		return;
+	}
+	Entry& entry = found->second;
+	entry.count--;
+	if (isAllRemoved || entry.count == 0) {
+		salaries_[int(entry.role)].erase(entry.salary);
+		names_.erase(entry.name);
+		entries_.erase(found);
+	}
+}
+
+void CompanyIndex::updateSalary(Employee* employee)
+{
+	auto found = entries_.find(employee);
+	if (found == entries_.end()) {
+		return;
+	}
+	Entry& entry = found->second;
+	SalaryIndex& salaries = salaries_[int(entry.role)];
+	auto node = salaries.extract(entry.salary);
+	node.key() = employee->getSalaryCents();
+	entry.salary = salaries.insert(move(node));
+}
+
+}
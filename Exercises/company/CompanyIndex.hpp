@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <optional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+using namespace std;
+
+#include <QObject>
+
+#include "Company.hpp"
+#include "Manager.hpp"
+
+
+namespace company {
+
+/**
+ * @brief The CompanyIndex class, secondary indexes over the employees of a company, to answer
+ * queries on salary, role, name prefix and manager without calling the getters of each employee.
+ *
+ * The employees are indexed by (role, salary) and by name, and the index is updated from the
+ * signals of the company. For each query, the index scan that reads the fewest employees is
+ * chosen (a salary range is counted up to the size of the best other choice, so estimating
+ * never costs more than scanning), and the other predicates are checked on the indexed values.
+ * For example, the managers earning between 80k and 120k cost O(log n + k).
+ */
+class CompanyIndex : public QObject
+{
+public:
+	/**
+	 * @brief SortKey The order of the results of a query
+	 */
+	enum class SortKey { none, name, salary, role };
+	/**
+	 * @brief GroupKey What the results of a query are grouped by
+	 */
+	enum class GroupKey { role, manager };
+	/**
+	 * @brief AccessPath The index scanned to answer a query
+	 */
+	enum class AccessPath { fullScan, salaryRange, role, namePrefix, manager };
+
+	/**
+	 * @brief The Query struct, the predicates (all must match) and the order of a query.
+	 * An employee added many times to the company is found as many times.
+	 */
+	struct Query {
+		optional<Role> role;                                      // Only the employees of this role
+		Cents          minSalary = numeric_limits<Cents>::min();  // Only the salaries (with bonus) from minSalary
+		Cents          maxSalary = numeric_limits<Cents>::max();  // to maxSalary, included
+		string         namePrefix;                                // Only the names (without status) starting with it
+		const Manager* manager = nullptr;                         // Only the employees managed by this manager
+		SortKey        sortKey = SortKey::none;                   // Without sort key, the order is unspecified
+		bool           isDescending = false;
+	};
+
+	/**
+	 * @brief The Group struct, the results of a query sharing the same role or manager
+	 */
+	struct Group {
+		Role              role = Role::employee; // With GroupKey::role
+		Manager*          manager = nullptr;     // With GroupKey::manager (null for the employees without manager)
+		vector<Employee*> employees;             // In the order of the query
+		Cents             totalSalary = 0;
+	};
+
+	// Constructors
+	/**
+	 * @brief CompanyIndex Constructor indexing the employees of a company, and following its changes
+	 * @param company The company to index, it must outlive the index
+	 */
+	explicit CompanyIndex(Company* company);
+
+	// Getters
+	/**
+	 * @brief find To find the employees matching a query
+	 * @param query The predicates and the order
+	 * @return The matching employees
+	 */
+	vector<Employee*> find(const Query& query) const;
+	/**
+	 * @brief group To find the employees matching a query, grouped by role or by manager
+	 * @param query The predicates and the order of the employees in each group
+	 * @param key What to group by. An employee managed by many managers of the company is in
+	 * the group of only one of them.
+	 * @return The non-empty groups, in the order of their first employee
+	 */
+	vector<Group> group(const Query& query, GroupKey key) const;
+	/**
+	 * @brief choosePath To know which index a query would scan
+	 * @param query The query
+	 * @return The chosen access path
+	 */
+	AccessPath choosePath(const Query& query) const;
+
+	// Setters
+	/**
+	 * @brief rebuild To index again all the employees of the company
+	 */
+	void rebuild();
+
+private:
+	using NameIndex = multimap<string, Employee*>;
+	using SalaryIndex = multimap<Cents, Employee*>;
+
+	/**
+	 * @brief The Entry struct, what is indexed for an employee (once, whatever its number of occurrences)
+	 */
+	struct Entry {
+		Role                  role;
+		int                   count;  // Number of occurrences in the company
+		SalaryIndex::iterator salary; // Its node in salaries_[role], to move it in O(log n)
+		NameIndex::iterator   name;   // Its node in names_
+	};
+	/**
+	 * @brief Match A matching employee and its entry
+	 */
+	using Match = pair<Employee*, const Entry*>;
+	/**
+	 * @brief The Plan struct, the access path chosen for a query and what it scans
+	 */
+	struct Plan {
+		AccessPath                     path = AccessPath::fullScan;
+		size_t                         cost = 0;
+		unordered_set<const Employee*> managed; // The employees of query.manager, if any
+	};
+
+	/**
+	 * @brief makePlan To choose the index that reads the fewest employees for a query
+	 */
+	Plan makePlan(const Query& query) const;
+	/**
+	 * @brief scan To call a function with each employee (and its entry) matching a query
+	 */
+	template <typename Fn>
+	void scan(const Query& query, const Plan& plan, Fn&& fn) const;
+	/**
+	 * @brief collect To find the employees matching a query, in its order (each occurrence once)
+	 */
+	vector<Match> collect(const Query& query) const;
+	/**
+	 * @brief matches To check the predicates of a query on an entry
+	 */
+	static bool matches(const Query& query, const Plan& plan, const Employee* employee, const Entry& entry);
+	/**
+	 * @brief add To index one more occurrence of an employee
+	 */
+	void add(Employee* employee);
+	/**
+	 * @brief remove To unindex one (or all) of the occurrences of an employee
+	 */
+	void remove(Employee* employee, bool isAllRemoved);
+	/**
+	 * @brief updateSalary To move an employee in the salary index after its salary changed
+	 */
+	void updateSalary(Employee* employee);
+
+	// Attributes
+	/**
+	 * @brief company_ To store the indexed company
+	 */
+	Company* company_;
+	/**
+	 * @brief entries_ To store the indexed values of each employee
+	 */
+	unordered_map<Employee*, Entry> entries_;
+	/**
+	 * @brief salaries_ To store the employees of each role, sorted by salary
+	 */
+	array<SalaryIndex, numberRoles> salaries_;
+	/**
+	 * @brief names_ To store the employees sorted by name (without status)
+	 */
+	NameIndex names_;
+};
+
+}
@@ -0,0 +1,699 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+using namespace std;
+
+#include "CompanyJournal.hpp"
+#include "FileIo.hpp"
+#include "Manager.hpp"
+#include "RosterSubscription.hpp"
+#include "Secretary.hpp"
+
+namespace company {
+
+namespace {
+
+// The integers are copied as they are in memory
+static_assert(endian::native == endian::little, "The journal format is little-endian");
+
+enum class RecordType : uint8_t { company = 1, employeeAdded, employeeDeleted, employeeDestroyed, salaryChanged, presidentChanged };
+enum class FileKind : uint8_t { snapshot = 1, journal };
+
+/* File header: magic, format version, kind of file and generation (a snapshot
+ * and the journal written after it have the same generation)
+ * Record: payload size and CRC32 of the payload, then the payload (type, id, fields)
+ */
+const char fileMagic[4] = {'C', 'J', 'N', 'L'};
+const uint32_t formatVersion = 1;
+const size_t recordHeaderSize = 2 * sizeof(uint32_t);
+const uint32_t maxPayloadSize = 1 << 20;
+
+array<uint32_t, 256> makeCrcTable()
+{
+	array<uint32_t, 256> table;
+	for (uint32_t i = 0; i < 256; i++) {
+		uint32_t crc = i;
+		for (int bit = 0; bit < 8; bit++)
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB8'8320 : crc >> 1;
+		table[i] = crc;
+	}
+	return table;
+}
+
+// The usual CRC-32 (the one of zip and PNG)
+uint32_t crc32(string_view data)
+{
+	static const array<uint32_t, 256> table = makeCrcTable();
+	uint32_t crc = 0xFFFF'FFFF;
+	for (char c : data)
+		crc = table[(crc ^ uint8_t(c)) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+template <typename T>
+void put(string& out, T value)
+{
+	char bytes[sizeof(T)];
+	memcpy(bytes, &value, sizeof(T));
+	out.append(bytes, sizeof(T));
+}
+
+void putString(string& out, const string& value)
+{
+	put(out, uint32_t(value.size()));
+	out += value;
+}
+
+void putFileHeader(string& out, FileKind kind, uint64_t generation)
+{
+	out.append(fileMagic, sizeof(fileMagic));
+	put(out, formatVersion);
+	put(out, uint8_t(kind));
+	put(out, generation);
+}
+
+void beginRecord(string& out, RecordType type, uint64_t id)
+{
+	out.clear();
+	out.append(recordHeaderSize, '\0');
+	put(out, uint8_t(type));
+	put(out, id);
+}
+
+void endRecord(string& out)
+{
+	if (out.size() - recordHeaderSize > maxPayloadSize)
+		throw length_error("Journal record too long");
+	uint32_t size = uint32_t(out.size() - recordHeaderSize);
+	uint32_t crc = crc32(string_view(out).substr(recordHeaderSize));
+	memcpy(out.data(), &size, sizeof(size));
+	memcpy(out.data() + sizeof(size), &crc, sizeof(crc));
+}
+
+void putEmployee(string& out, Employee* employee)
+{
+	auto manager = dynamic_cast<Manager*>(employee);
+	put(out, uint8_t(employee->getRole()));
+	put(out, employee->getBaseSalaryCents());
+	put(out, manager != nullptr ? manager->getBonusBasisPoints() : BasisPoints(0));
+	// The name without the status added by the subclasses
+	putString(out, employee->Employee::getName());
+}
+
+/**
+ * Reads the fields of a record, isValid() becomes false if they go past its end
+ */
+class FieldReader
+{
+public:
+	explicit FieldReader(string_view data) : data_(data) { }
+
+	template <typename T>
+	T get()
+	{
+		T value{};
+		if (data_.size() < sizeof(T)) {
+			isValid_ = false;
+			return value;
+		}
+		memcpy(&value, data_.data(), sizeof(T));
+		data_.remove_prefix(sizeof(T));
+		return value;
+	}
+
+	string getString()
+	{
+		uint32_t size = get<uint32_t>();
+		if (data_.size() < size) {
+			isValid_ = false;
+			return {};
+		}
+		string value(data_.substr(0, size));
+		data_.remove_prefix(size);
+		return value;
+	}
+
+	bool isValid() const { return isValid_; }
+	bool isAtEnd() const { return data_.empty(); }
+
+private:
+	string_view data_;
+	bool        isValid_ = true;
+};
+
+// Reads the header of a file and returns its generation, or false if it isn't a file of that kind
+bool readFileHeader(string_view& data, FileKind kind, uint64_t& generation)
+{
+	FieldReader reader(data);
+	char magic[4];
+	for (char& c : magic)
+		c = reader.get<char>();
+	uint32_t version = reader.get<uint32_t>();
+	uint8_t fileKind = reader.get<uint8_t>();
+	generation = reader.get<uint64_t>();
+	if (!reader.isValid() || memcmp(magic, fileMagic, sizeof(fileMagic)) != 0 ||
+	    version != formatVersion || fileKind != uint8_t(kind))
+		return false;
+	data.remove_prefix(sizeof(fileMagic) + sizeof(version) + sizeof(fileKind) + sizeof(generation));
+	return true;
+}
+
+// Reads the next record, or returns false if it is incomplete or its checksum doesn't match
+bool readRecord(string_view& data, string_view& payload)
+{
+	if (data.size() < recordHeaderSize)
+		return false;
+	uint32_t size, crc;
+	memcpy(&size, data.data(), sizeof(size));
+	memcpy(&crc, data.data() + sizeof(size), sizeof(crc));
+	if (size > maxPayloadSize || data.size() - recordHeaderSize < size)
+		return false;
+	payload = data.substr(recordHeaderSize, size);
+	if (crc32(payload) != crc)
+		return false;
+	data.remove_prefix(recordHeaderSize + size);
+	return true;
+}
+
+string readFile(const string& filename)
+{
+	ifstream file(filename, ios::binary);
+	if (!file)
+		throw system_error(make_error_code(errc::no_such_file_or_directory), "Cannot open " + filename);
+	return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+unique_ptr<Employee> createEmployee(Role role, const string& name, Cents salary, BasisPoints bonus)
+{
+	unique_ptr<Employee> employee;
+	switch (role) {
+	case Role::manager: {
+		auto manager = make_unique<Manager>(name, 0, 0);
+		manager->setBonusBasisPoints(bonus);
+		employee = move(manager);
+		break;
+	}
+	case Role::secretary:
+		employee = make_unique<Secretary>(name, 0);
+		break;
+	default:
+		employee = make_unique<Employee>(name);
+		break;
+	}
+	employee->setSalaryCents(salary);
+	return employee;
+}
+
+/**
+ * Applies the records of a snapshot or a journal to a recovered company
+ */
+class RecoveryBuilder
+{
+public:
+	explicit RecoveryBuilder(CompanyJournal::Recovery& recovery) : recovery_(recovery) { }
+
+	// Returns false if the record is invalid (the checksum matched, but not the content)
+	bool apply(string_view payload)
+	{
+		FieldReader reader(payload);
+		auto type = RecordType(reader.get<uint8_t>());
+		uint64_t id = reader.get<uint64_t>();
+		if (!reader.isValid())
+			return false;
+
+		if (type == RecordType::company) {
+			string name = reader.getString();
+			bool hasPresident = reader.get<uint8_t>() != 0;
+			string presidentName = reader.getString();
+			if (!reader.isValid() || !reader.isAtEnd() || recovery_.company != nullptr)
+				return false;
+			recovery_.company = hasPresident ? make_unique<Company>(name, presidentName) : make_unique<Company>();
+			return true;
+		}
+		if (recovery_.company == nullptr)
+			return false;
+		Company& company = *recovery_.company;
+
+		switch (type) {
+		case RecordType::employeeAdded: {
+			auto role = Role(reader.get<uint8_t>());
+			Cents salary = reader.get<Cents>();
+			BasisPoints bonus = reader.get<BasisPoints>();
+			string name = reader.getString();
+			if (!reader.isValid() || int(role) >= numberRoles)
+				return false;
+			// The whole employee is in each addition, but it is only created the first time
+			Employee*& employee = employees_[id];
+			if (employee == nullptr) {
+				recovery_.employees.push_back(createEmployee(role, name, salary, bonus));
+				employee = recovery_.employees.back().get();
+			}
+			company.addEmployee(employee);
+			break;
+		}
+		case RecordType::employeeDeleted:
+			if (Employee* employee = find(id))
+				company.delEmployee(employee);
+			break;
+		case RecordType::employeeDestroyed:
+			if (Employee* employee = find(id)) {
+				while (company.getPayroll().isTracked(employee))
+					company.delEmployee(employee);
+				employees_.erase(id);
+			}
+			break;
+		case RecordType::salaryChanged: {
+			Cents salary = reader.get<Cents>();
+			BasisPoints bonus = reader.get<BasisPoints>();
+			if (!reader.isValid())
+				return false;
+			if (Employee* employee = find(id)) {
+				employee->setSalaryCents(salary);
+				if (auto manager = dynamic_cast<Manager*>(employee))
+					manager->setBonusBasisPoints(bonus);
+			}
+			break;
+		}
+		case RecordType::presidentChanged: {
+			Employee president(reader.getString());
+			if (!reader.isValid())
+				return false;
+			company.setPresident(&president);
+			break;
+		}
+		default:
+			return false;
+		}
+		return reader.isAtEnd();
+	}
+
+private:
+	Employee* find(uint64_t id) const
+	{
+		auto it = employees_.find(id);
+		return it != employees_.end() ? it->second : nullptr;
+	}
+
+	CompanyJournal::Recovery&          recovery_;
+	unordered_map<uint64_t, Employee*> employees_;
+};
+
+}
+
+CompanyJournal::CompanyJournal(Company* company, string snapshotFilename, string journalFilename,
+                               chrono::milliseconds commitInterval)
+	: company_(company), snapshotFilename_(move(snapshotFilename)),
+	  journalFilename_(move(journalFilename)), commitInterval_(commitInterval)
+{
+	// A random first generation, so a journal is never taken for the one of another snapshot
+	random_device seed;
+	generation_ = (uint64_t(seed()) << 32) | seed();
+	writeSnapshot();
+
+	// The salary changes and the destroyed employees are logged as their observer
+	connectRoster(company_, this, {
+		.added = [this](Employee* employee) { logEmployeeAdded(employee); },
+		.deleted = [this](Employee* employee) { logEmployeeDeleted(employee); },
+		.replaced = [this]() { logRosterReplaced(); },
+	});
+	connect(company_, &Company::presidentChanged, this, [this](Employee* president) { logPresidentChanged(president); });
+
+	flusher_ = jthread([this](stop_token stopToken) { runFlusher(stopToken); });
+}
+
+CompanyJournal::~CompanyJournal()
+{
+	try {
+		sync();
+	} catch (...) {
+		// The error was already reported to the callers of sync()
+	}
+	forgetEmployees();
+	flusher_.request_stop();
+	flusher_.join();
+	if (fileDescriptor_ >= 0) {
+		closeFile(fileDescriptor_);
+	}
+}
+
+uint64_t CompanyJournal::getNumberRecords() const
+{
+	lock_guard lock(mutex_);
+	return nRecordsSinceSnapshot_;
+}
+
+uint64_t CompanyJournal::getNumberSyncs() const
+{
+	lock_guard lock(mutex_);
+	return nSyncs_;
+}
+
+void CompanyJournal::sync()
+{
+	unique_lock lock(mutex_);
+	uint64_t target = nAppended_;
+	if (nDurable_ < target) {
+		isSyncRequested_ = true;
+		changed_.notify_all();
+		changed_.wait(lock, [&] { return nDurable_ >= target || error_ != nullptr; });
+	}
+	throwIfFailed();
+}
+
+void CompanyJournal::checkpoint()
+{
+	sync();
+	// The background thread has nothing left to write, it won't touch the file
+	lock_guard fileLock(fileMutex_);
+	writeSnapshot();
+}
+
+CompanyJournal::Recovery CompanyJournal::recover(const string& snapshotFilename, const string& journalFilename)
+{
+	Recovery recovery;
+	RecoveryBuilder builder(recovery);
+
+	// The snapshot was renamed into place once complete, so it must be entirely valid
+	string snapshot = readFile(snapshotFilename);
+	string_view data = snapshot;
+	uint64_t generation;
+	if (!readFileHeader(data, FileKind::snapshot, generation))
+		throw runtime_error("Invalid company snapshot " + snapshotFilename);
+	string_view payload;
+	while (!data.empty()) {
+		if (!readRecord(data, payload) || !builder.apply(payload))
+			throw runtime_error("Corrupted company snapshot " + snapshotFilename);
+	}
+	if (recovery.company == nullptr)
+		throw runtime_error("Invalid company snapshot " + snapshotFilename);
+
+	string journal;
+	try {
+		journal = readFile(journalFilename);
+	} catch (system_error&) {
+		// No journal, the snapshot is all there is
+		return recovery;
+	}
+	data = journal;
+	uint64_t journalGeneration;
+	// A journal of another generation is older than the snapshot (a crash during a checkpoint)
+	if (!readFileHeader(data, FileKind::journal, journalGeneration) || journalGeneration != generation)
+		return recovery;
+	while (!data.empty()) {
+		if (!readRecord(data, payload) || !builder.apply(payload)) {
+			// The end of a write interrupted by the crash, the records after it can't be trusted
+			recovery.isTailDiscarded = true;
+			break;
+		}
+		recovery.nReplayedRecords++;
+	}
+	return recovery;
+}
+
+void CompanyJournal::onEmployeeSalaryChanged(Employee* employee, Cents, Cents)
+{
+	/* Logged even for the employees no longer in the company,
+	 * since they are restored with their last salary if they come back
+	 */
+	auto manager = dynamic_cast<Manager*>(employee);
+	beginRecord(record_, RecordType::salaryChanged, getId(employee));
+	put(record_, employee->getBaseSalaryCents());
+	put(record_, manager != nullptr ? manager->getBonusBasisPoints() : BasisPoints(0));
+	endRecord(record_);
+	append(record_);
+}
+
+void CompanyJournal::onEmployeeDestroyed(Employee* employee)
+{
+	// The company drops a destroyed employee without signal, so it is logged here
+	auto it = ids_.find(employee);
+	if (it == ids_.end()) {
+		return;
+	}
+	beginRecord(record_, RecordType::employeeDestroyed, it->second);
+	endRecord(record_);
+	// Its address may be reused by a new employee, which must get a new id
+	ids_.erase(it);
+	append(record_);
+}
+
+void CompanyJournal::logEmployeeAdded(Employee* employee)
+{
+	beginRecord(record_, RecordType::employeeAdded, getId(employee));
+	putEmployee(record_, employee);
+	endRecord(record_);
+	append(record_);
+}
+
+void CompanyJournal::logEmployeeDeleted(Employee* employee)
+{
+	beginRecord(record_, RecordType::employeeDeleted, getId(employee));
+	endRecord(record_);
+	append(record_);
+}
+
+void CompanyJournal::logRosterReplaced()
+{
+	/* No record holds a whole roster, so a new snapshot replaces the journal. A slot must not
+	 * throw: if it can't be written, the journal no longer matches the company and stops,
+	 * which sync() reports
+	 */
+	try {
+		checkpoint();
+	} catch (...) {
+		lock_guard lock(mutex_);
+		if (!error_) {
+			error_ = current_exception();
+		}
+		changed_.notify_all();
+	}
+}
+
+void CompanyJournal::logPresidentChanged(Employee* president)
+{
+	beginRecord(record_, RecordType::presidentChanged, 0);
+	putString(record_, president->getName());
+	endRecord(record_);
+	append(record_);
+}
+
+uint64_t CompanyJournal::getId(Employee* employee)
+{
+	auto [it, isNew] = ids_.try_emplace(employee, nextId_);
+	if (isNew) {
+		nextId_++;
+		// Observed to log its salary changes and its destruction
+		employee->addObserver(this);
+	}
+	return it->second;
+}
+
+void CompanyJournal::forgetEmployees()
+{
+	for (auto&& [employee, id] : ids_) {
+		employee->removeObserver(this);
+	}
+	ids_.clear();
+	nextId_ = 0;
+}
+
+void CompanyJournal::append(const string& record)
+{
+	lock_guard lock(mutex_);
+	// Called from the signals of the company, so it doesn't throw: after a failed write, sync() reports the error
+	if (error_ != nullptr) {
+		return;
+	}
+	bool wasEmpty = pending_.empty();
+	pending_ += record;
+	nAppended_++;
+	nRecordsSinceSnapshot_++;
+	// The background thread waits for a first record, then for the end of the commit interval
+	if (wasEmpty || pending_.size() >= maxPendingBytes) {
+		changed_.notify_all();
+	}
+}
+
+void CompanyJournal::writeSnapshot()
+{
+	/* The snapshot gets its own ids and generation, which replace ours only once its journal
+	 * is open: until then, the records still go to the previous journal with the previous ids
+	 */
+	unordered_map<Employee*, uint64_t> ids;
+	uint64_t generation = generation_ + 1;
+
+	string data;
+	putFileHeader(data, FileKind::snapshot, generation);
+	// A company without president can only be a default one, which has no name either
+	Employee* president = company_->getPresident();
+	beginRecord(record_, RecordType::company, 0);
+	putString(record_, company_->getName());
+	put(record_, uint8_t(president != nullptr));
+	putString(record_, president != nullptr ? president->getName() : string());
+	endRecord(record_);
+	data += record_;
+	for (int i = 0; i < company_->getNumberEmployees(); i++) {
+		Employee* employee = company_->getEmployee(i);
+		uint64_t id = ids.try_emplace(employee, ids.size()).first->second;
+		beginRecord(record_, RecordType::employeeAdded, id);
+		putEmployee(record_, employee);
+		endRecord(record_);
+		data += record_;
+	}
+
+	// Written beside, then renamed over the previous one, so there is always a complete snapshot
+	string temporaryFilename = snapshotFilename_ + ".tmp";
+	try {
+		int snapshotFile = openForWriting(temporaryFilename);
+		try {
+			writeAll(snapshotFile, data, "Cannot write the company snapshot");
+			syncFile(snapshotFile);
+		} catch (...) {
+			closeFile(snapshotFile);
+			throw;
+		}
+		closeFile(snapshotFile);
+		filesystem::rename(temporaryFilename, snapshotFilename_);
+	} catch (...) {
+		// The previous snapshot and journal are untouched, the journal goes on with them
+		error_code ignored;
+		filesystem::remove(temporaryFilename, ignored);
+		throw;
+	}
+
+	/* From the rename on, recovery ignores the previous journal (older generation): if the
+	 * new one can't be started, nothing more can be logged
+	 */
+	int journalFile = -1;
+	try {
+		syncDirectoryOf(snapshotFilename_);
+		journalFile = openForWriting(journalFilename_);
+		data.clear();
+		putFileHeader(data, FileKind::journal, generation);
+		writeAll(journalFile, data, "Cannot write the company journal");
+		syncFile(journalFile);
+		syncDirectoryOf(journalFilename_);
+	} catch (...) {
+		if (journalFile >= 0) {
+			closeFile(journalFile);
+		}
+		lock_guard lock(mutex_);
+		error_ = current_exception();
+		changed_.notify_all();
+		throw;
+	}
+
+	if (fileDescriptor_ >= 0) {
+		closeFile(fileDescriptor_);
+	}
+	fileDescriptor_ = journalFile;
+	forgetEmployees();
+	// Observed to log their salary changes and their destruction
+	for (auto&& [employee, id] : ids) {
+		employee->addObserver(this);
+	}
+	ids_ = move(ids);
+	nextId_ = ids_.size();
+	generation_ = generation;
+
+	lock_guard lock(mutex_);
+	nRecordsSinceSnapshot_ = 0;
+}
+
+void CompanyJournal::runFlusher(stop_token stopToken)
+{
+	string batch;
+	unique_lock lock(mutex_);
+	auto hasWork = [this] { return !pending_.empty() || isSyncRequested_; };
+	while (true) {
+		changed_.wait(lock, stopToken, hasWork);
+		if (!hasWork()) {
+			// Stop requested, with nothing left to write
+			return;
+		}
+		// Group commit: the records appended during the interval share the same sync
+		if (!isSyncRequested_) {
+			changed_.wait_for(lock, stopToken, commitInterval_,
+			                  [this] { return isSyncRequested_ || pending_.size() >= maxPendingBytes; });
+		}
+		swap(batch, pending_);
+		uint64_t target = nAppended_;
+		isSyncRequested_ = false;
+		lock.unlock();
+
+		exception_ptr error;
+		if (!batch.empty()) {
+			try {
+				lock_guard fileLock(fileMutex_);
+				writeAll(fileDescriptor_, batch, "Cannot write the company journal");
+				syncFile(fileDescriptor_);
+			} catch (...) {
+				error = current_exception();
+			}
+		}
+
+		lock.lock();
+		if (error != nullptr) {
+			// Reported to every later sync() and append(), the journal can't go on
+			error_ = error;
+			changed_.notify_all();
+			return;
+		}
+		if (!batch.empty()) {
+			nSyncs_++;
+		}
+		nDurable_ = target;
+		batch.clear();
+		changed_.notify_all();
+	}
+}
+
+void CompanyJournal::throwIfFailed() const
+{
+	// Called with mutex_ held
+	if (error_ != nullptr) {
+		rethrow_exception(error_);
+	}
+}
+
+}
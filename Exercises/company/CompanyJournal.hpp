@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+#include <QObject>
+
+#include "Company.hpp"
+#include "EmployeeObserver.hpp"
+
+
+namespace company {
+
+/**
+ * @brief The CompanyJournal class, an append-only write-ahead journal of the mutations of a company
+ * (addEmployee, delEmployee, setPresident, salary and bonus changes), so they survive a crash.
+ *
+ * Each mutation is encoded as a small binary record protected by a CRC32 and appended to an
+ * in-memory buffer. A background thread writes the buffer and syncs it to disk (fsync, or
+ * _commit on Windows) once per commit interval, so many records share each (slow) sync while
+ * a record is never waiting more than about one interval to be durable. sync() waits for that.
+ * If a write fails, the next records are dropped and sync() throws the error.
+ *
+ * The journal applies on top of a snapshot of the whole company, written when the journal is
+ * created and by checkpoint(). recover() reads the snapshot and replays the journal, up to the
+ * first incomplete or corrupted record (the end of a write interrupted by the crash).
+ * Assigning a whole company (operator=) writes a new snapshot, as checkpoint() does. The
+ * employees of the managers are not journaled.
+ */
+class CompanyJournal : public QObject, public EmployeeObserver
+{
+public:
+	/**
+	 * @brief The Recovery struct, a company rebuilt from a snapshot and its journal.
+	 * The employees are declared first, so the company is destroyed before them.
+	 */
+	struct Recovery {
+		vector<unique_ptr<Employee>> employees;
+		unique_ptr<Company>          company;
+		uint64_t                     nReplayedRecords = 0;
+		bool                         isTailDiscarded = false;
+	};
+
+	/**
+	 * @brief defaultCommitInterval The default maximal time between a mutation and its sync to disk
+	 */
+	static inline const chrono::milliseconds defaultCommitInterval{5};
+	/**
+	 * @brief maxPendingBytes Size (in bytes) of the pending records after which they are written without waiting
+	 */
+	static inline const size_t maxPendingBytes = 4 << 20;
+
+	// Constructors
+	/**
+	 * @brief CompanyJournal Constructor, writes a snapshot of the company and starts an empty journal
+	 * @param company The company whose mutations are journaled, it must outlive the journal
+	 * @param snapshotFilename The file of the snapshot (replaced atomically)
+	 * @param journalFilename The file of the journal (emptied)
+	 * @param commitInterval The maximal time between a mutation and its sync to disk
+	 */
+	CompanyJournal(Company* company, string snapshotFilename, string journalFilename,
+	               chrono::milliseconds commitInterval = defaultCommitInterval);
+	CompanyJournal(const CompanyJournal&) = delete;
+	/**
+	 * @brief ~CompanyJournal Destructor, syncs the pending records and stops the background thread
+	 */
+	~CompanyJournal();
+
+	CompanyJournal& operator=(const CompanyJournal&) = delete;
+
+	// Getters
+	/**
+	 * @brief getNumberRecords To get the number of records appended since the last snapshot
+	 * @return The number of records
+	 */
+	uint64_t getNumberRecords() const;
+	/**
+	 * @brief getNumberSyncs To get the number of syncs to disk done by the background thread
+	 * @return The number of syncs (much less than the number of records, thanks to the group commit)
+	 */
+	uint64_t getNumberSyncs() const;
+
+	/**
+	 * @brief sync To wait until all the records appended so far are on disk
+	 */
+	void sync();
+	/**
+	 * @brief checkpoint To write a new snapshot of the company and start again from an empty journal
+	 * If the snapshot can't be written, the current journal goes on; if it is written but the
+	 * new journal can't be started, nothing more is logged and sync() reports the error
+	 */
+	void checkpoint();
+	/**
+	 * @brief recover To rebuild a company from a snapshot and the journal written after it.
+	 * A journal older than the snapshot (a crash during checkpoint) is ignored.
+	 * @param snapshotFilename The file of the snapshot
+	 * @param journalFilename The file of the journal
+	 * @return The company and the employees it owns
+	 */
+	static Recovery recover(const string& snapshotFilename, const string& journalFilename);
+
+	// EmployeeObserver
+	virtual void onEmployeeSalaryChanged(Employee* employee, Cents oldSalary, Cents newSalary);
+	virtual void onEmployeeDestroyed(Employee* employee);
+
+private:
+	/**
+	 * @brief logEmployeeAdded To log an addition, with the whole employee (role, name, salary and bonus)
+	 */
+	void logEmployeeAdded(Employee* employee);
+	/**
+	 * @brief logEmployeeDeleted To log a deletion
+	 */
+	void logEmployeeDeleted(Employee* employee);
+	/**
+	 * @brief logRosterReplaced To start again from a snapshot after an assignment of the company
+	 */
+	void logRosterReplaced();
+	/**
+	 * @brief logPresidentChanged To log a new president
+	 */
+	void logPresidentChanged(Employee* president);
+	/**
+	 * @brief getId To get the id of an employee in the records, assigning one (and observing the employee) if needed
+	 */
+	uint64_t getId(Employee* employee);
+	/**
+	 * @brief forgetEmployees To forget the ids of all the employees and stop observing them
+	 */
+	void forgetEmployees();
+	/**
+	 * @brief append To add an encoded record to the pending ones
+	 */
+	void append(const string& record);
+	/**
+	 * @brief writeSnapshot To write the snapshot of the company and an empty journal of a new generation
+	 */
+	void writeSnapshot();
+	/**
+	 * @brief runFlusher The loop of the background thread, writing and syncing the pending records
+	 */
+	void runFlusher(stop_token stopToken);
+	/**
+	 * @brief throwIfFailed To rethrow the error of the background thread, if any (mutex_ must be held)
+	 */
+	void throwIfFailed() const;
+
+	// Attributes
+	/**
+	 * @brief company_ To store the journaled company
+	 */
+	Company* company_;
+	/**
+	 * @brief snapshotFilename_ To store the file of the snapshot
+	 */
+	string snapshotFilename_;
+	/**
+	 * @brief journalFilename_ To store the file of the journal
+	 */
+	string journalFilename_;
+	/**
+	 * @brief commitInterval_ To store the maximal time between a mutation and its sync to disk
+	 */
+	chrono::milliseconds commitInterval_;
+	/**
+	 * @brief generation_ To store the generation of the current snapshot and journal
+	 */
+	uint64_t generation_ = 0;
+	/**
+	 * @brief ids_ To store the ids of the employees in the records of the current generation
+	 */
+	unordered_map<Employee*, uint64_t> ids_;
+	/**
+	 * @brief nextId_ To store the id of the next new employee
+	 */
+	uint64_t nextId_ = 0;
+	/**
+	 * @brief record_ To store the record being encoded (reused to avoid an allocation per record)
+	 */
+	string record_;
+
+	/**
+	 * @brief fileMutex_ To protect the journal file, held by the background thread while it writes
+	 */
+	mutex fileMutex_;
+	/**
+	 * @brief fileDescriptor_ To store the open journal file
+	 */
+	int fileDescriptor_ = -1;
+
+	/**
+	 * @brief mutex_ To protect the pending records, the counters and the error below
+	 */
+	mutable mutex mutex_;
+	/**
+	 * @brief changed_ To wake the background thread (new records, sync requested) and the callers of sync()
+	 */
+	condition_variable_any changed_;
+	/**
+	 * @brief pending_ To store the encoded records not written yet
+	 */
+	string pending_;
+	/**
+	 * @brief nAppended_ To store the number of records appended since the journal was created
+	 */
+	uint64_t nAppended_ = 0;
+	/**
+	 * @brief nDurable_ To store how many of the appended records are on disk
+	 */
+	uint64_t nDurable_ = 0;
+	/**
+	 * @brief nRecordsSinceSnapshot_ To store the number of records appended since the last snapshot
+	 */
+	uint64_t nRecordsSinceSnapshot_ = 0;
+	/**
+	 * @brief nSyncs_ To store the number of syncs to disk
+	 */
+	uint64_t nSyncs_ = 0;
+	/**
+	 * @brief isSyncRequested_ To ask the background thread to write without waiting for the end of the interval
+	 */
+	bool isSyncRequested_ = false;
+	/**
+	 * @brief error_ To store the error of the background thread, after which nothing more is written
+	 */
+	exception_ptr error_;
+
+	/**
+	 * @brief flusher_ The background thread, declared last to be stopped (and joined) first
+	 */
+	jthread flusher_;
+};
+
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#include <functional>
+#include <mutex>
+using namespace std;
+
+#include "CompanyRegistry.hpp"
+#include "RosterSubscription.hpp"
+
+namespace company {
+
+CompanyRegistry::CompanyRegistry()
+	: shards_(make_unique<array<Shard, numberShards>>())
+{
+}
+
+CompanyRegistry::~CompanyRegistry()
+{
+	// The companies don't send signals when they are destroyed, so the index simply goes with them
+}
+
+int CompanyRegistry::getNumberCompanies() const
+{
+	return int(companies_.size());
+}
+
+Company* CompanyRegistry::getCompany(int index) const
+{
+	if (index >= 0 && index < int(companies_.size())) {
+		return companies_[index].get();
+	}
+	return nullptr;
+}
+
+int CompanyRegistry::getNumberEmployments() const
+{
+	return nEmployments_.load(memory_order_relaxed);
+}
+
+vector<CompanyRegistry::Employment> CompanyRegistry::findByName(const string& name) const
+{
+	Shard& shard = getShard(name);
+	shared_lock lock(shard.mutex);
+	vector<Employment> found;
+	auto [first, last] = shard.employments.equal_range(name);
+	for (auto it = first; it != last; ++it) {
+		found.push_back(it->second);
+	}
+	return found;
+}
+
+bool CompanyRegistry::isEmployed(const string& name) const
+{
+	Shard& shard = getShard(name);
+	shared_lock lock(shard.mutex);
+	return shard.employments.contains(name);
+}
+
+Company* CompanyRegistry::createCompany(string name, string presidentName)
+{
+	return addCompany(make_unique<Company>(move(name), move(presidentName)));
+}
+
+Company* CompanyRegistry::addCompany(unique_ptr<Company> company)
+{
+	Company* added = company.get();
+	if (companyIndices_.contains(added)) {
+		return added;
+	}
+	companyIndices_[added] = companies_.size();
+	companies_.push_back(move(company));
+	for (int i = 0; i < added->getNumberEmployees(); i++) {
+		index(added, added->getEmployee(i));
+	}
+	connectCompany(added);
+	return added;
+}
+
+unique_ptr<Company> CompanyRegistry::removeCompany(Company* company)
+{
+	auto found = companyIndices_.find(company);
+	if (found == companyIndices_.end()) {
+		return nullptr;
+	}
+	disconnect(company, nullptr, this, nullptr);
+	for (int i = 0; i < company->getNumberEmployees(); i++) {
+		Employee* employee = company->getEmployee(i);
+		unindex(company, employee, employee->Employee::getName(), false);
+	}
+
+	// The last company takes the place of the removed one
+	size_t index = found->second;
+	unique_ptr<Company> removed = move(companies_[index]);
+	companies_[index] = move(companies_.back());
+	companies_.pop_back();
+	companyIndices_.erase(found);
+	if (index < companies_.size()) {
+		companyIndices_[companies_[index].get()] = index;
+	}
+	return removed;
+}
+
+CompanyRegistry::Shard& CompanyRegistry::getShard(const string& name) const
+{
+	return (*shards_)[hash<string>()(name) % numberShards];
+}
+
+void CompanyRegistry::index(Company* company, Employee* employee)
+{
+	string name = employee->Employee::getName();
+	Shard& shard = getShard(name);
+	unique_lock lock(shard.mutex);
+	shard.employments.emplace(move(name), Employment{company, employee});
+	nEmployments_.fetch_add(1, memory_order_relaxed);
+}
+
+void CompanyRegistry::unindex(Company* company, Employee* employee, const string& name, bool isAllRemoved)
+{
+	Shard& shard = getShard(name);
+	unique_lock lock(shard.mutex);
+	auto [first, last] = shard.employments.equal_range(name);
+	for (auto it = first; it != last;) {
+		if (it->second == Employment{company, employee}) {
+			it = shard.employments.erase(it);
+			nEmployments_.fetch_sub(1, memory_order_relaxed);
+			if (!isAllRemoved) {
+				return;
+			}
+		} else {
+			++it;
+		}
+	}
+}
+
+void CompanyRegistry::connectCompany(Company* company)
+{
+	connectRoster(company, this, {
+		.added = [this, company](Employee* employee) { index(company, employee); },
+		.deleted = [this, company](Employee* employee) {
+			unindex(company, employee, employee->Employee::getName(), false);
+		},
+		// The employee is in its destructor, where Employee::getName() is still valid
+		.destroyed = [this, company](Employee* employee) {
+			unindex(company, employee, employee->Employee::getName(), true);
+		},
+		.replaced = [this, company]() { reindex(company); },
+	});
+}
+
+void CompanyRegistry::reindex(Company* company)
+{
+	/* The previous employees are gone from the company, so its entries are found by sweeping
+	 * all the shards (an assignment is rare, and the employees are read again anyway)
+	 */
+	for (Shard& shard : *shards_) {
+		unique_lock lock(shard.mutex);
+		erase_if(shard.employments, [this, company](const auto& entry) {
+			if (entry.second.company != company) {
+				return false;
+			}
+			nEmployments_.fetch_sub(1, memory_order_relaxed);
+			return true;
+		});
+	}
+	for (int i = 0; i < company->getNumberEmployees(); i++) {
+		index(company, company->getEmployee(i));
+	}
+}
+
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+#include <QObject>
+
+#include "Company.hpp"
+
+
+namespace company {
+
+/**
+ * @brief The CompanyRegistry class, owns many companies and indexes all their employees by name,
+ * to find which companies employ someone without searching each company.
+ *
+ * The index is updated from the signals of the companies (additions, deletions, merges,
+ * destroyed employees and assignments). It is split in shards, each with its own lock and hash table, so
+ * findByName() can be called from any thread while the companies change, without contention
+ * on a single lock. The companies themselves must be changed from a single thread.
+ * An employee is indexed by its name without status (Employee::getName()), which must not
+ * change while it is registered.
+ */
+class CompanyRegistry : public QObject
+{
+public:
+	/**
+	 * @brief The Employment struct, an employee and a company that employs it
+	 */
+	struct Employment {
+		Company*  company;
+		Employee* employee;
+
+		bool operator==(const Employment&) const = default;
+	};
+
+	/**
+	 * @brief numberShards The number of independent parts of the index
+	 */
+	static inline const size_t numberShards = 64;
+
+	// Constructors
+	/**
+	 * @brief CompanyRegistry The default constructor, without companies
+	 */
+	CompanyRegistry();
+	CompanyRegistry(const CompanyRegistry&) = delete;
+	/**
+	 * @brief ~CompanyRegistry The destructor, destroys the companies
+	 */
+	~CompanyRegistry();
+
+	CompanyRegistry& operator=(const CompanyRegistry&) = delete;
+
+	// Getters
+	/**
+	 * @brief getNumberCompanies To get the number of registered companies
+	 * @return The number of companies
+	 */
+	int getNumberCompanies() const;
+	/**
+	 * @brief getCompany To get a company using its index
+	 * @param index The index of the company (it may change when a company is removed)
+	 * @return The company, or a null pointer if there is none at that index
+	 */
+	Company* getCompany(int index) const;
+	/**
+	 * @brief getNumberEmployments To get the number of (company, employee) pairs in the index, O(1)
+	 * @return The total number of employees of all the companies
+	 */
+	int getNumberEmployments() const;
+	/**
+	 * @brief findByName To find the companies that employ someone, in O(1) (average). Thread-safe.
+	 * @param name The name of the employee, without status
+	 * @return The employments of that name (once per occurrence in a company)
+	 */
+	vector<Employment> findByName(const string& name) const;
+	/**
+	 * @brief isEmployed To know if someone is employed by any registered company. Thread-safe.
+	 * @param name The name of the employee, without status
+	 * @return Whether or not a company employs someone of that name
+	 */
+	bool isEmployed(const string& name) const;
+
+	// Setters
+	/**
+	 * @brief createCompany To create a company owned by the registry
+	 * @param name The company name
+	 * @param presidentName The president name
+	 * @return The new company
+	 */
+	Company* createCompany(string name, string presidentName);
+	/**
+	 * @brief addCompany To take ownership of a company and index its employees
+	 * @param company The company to add
+	 * @return The company, now owned by the registry
+	 */
+	Company* addCompany(unique_ptr<Company> company);
+	/**
+	 * @brief removeCompany To remove a company from the registry (and its employees from the index)
+	 * @param company The company to remove
+	 * @return The company, now owned by the caller (or null if it wasn't registered)
+	 */
+	unique_ptr<Company> removeCompany(Company* company);
+
+private:
+	/**
+	 * @brief The Shard struct, a part of the index with its own lock
+	 */
+	struct Shard {
+		mutable shared_mutex                       mutex;
+		unordered_multimap<string, Employment>     employments;
+	};
+
+	/**
+	 * @brief getShard To get the shard that indexes a name
+	 */
+	Shard& getShard(const string& name) const;
+	/**
+	 * @brief index To add an employment to the index
+	 */
+	void index(Company* company, Employee* employee);
+	/**
+	 * @brief unindex To remove one (or all) of the employments of an employee by a company
+	 * @param name The name of the employee (given because it can be in its destructor)
+	 */
+	void unindex(Company* company, Employee* employee, const string& name, bool isAllRemoved);
+	/**
+	 * @brief connectCompany To update the index from the signals of a company
+	 */
+	void connectCompany(Company* company);
+	/**
+	 * @brief reindex To replace all the employments of a company by its current employees
+	 */
+	void reindex(Company* company);
+
+	// Attributes
+	/**
+	 * @brief companies_ To store the registered companies
+	 */
+	vector<unique_ptr<Company>> companies_;
+	/**
+	 * @brief companyIndices_ To store the index of each company in companies_, for O(1) removal
+	 */
+	unordered_map<Company*, size_t> companyIndices_;
+	/**
+	 * @brief nEmployments_ To store the number of entries of the index, atomic since it is read
+	 * without the shard locks while the companies change
+	 */
+	atomic<int> nEmployments_ = 0;
+	/**
+	 * @brief shards_ To store the parts of the index, allocated once
+	 */
+	unique_ptr<array<Shard, numberShards>> shards_;
+};
+
+}
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#include "CompanyReportWriter.hpp"
+#include "FileIo.hpp"
+
+namespace company {
+
+namespace {
+
+const char* const writeErrorMessage = "Cannot write the company report";
+
+void appendInt(string& out, int value)
+{
+	char buffer[16];
+	auto [end, error] = to_chars(buffer, buffer + sizeof(buffer), value);
+	out.append(buffer, end);
+}
+
+// Same digits as an ostream with its default settings (general notation, 6 significant digits)
+void appendStreamDouble(string& out, double value)
+{
+	char buffer[32];
+	auto [end, error] = to_chars(buffer, buffer + sizeof(buffer), value, chars_format::general, 6);
+	out.append(buffer, end);
+}
+
+// Shortest representation that reads back as the same value, for the machine-readable formats
+void appendExactDouble(string& out, double value)
+{
+	char buffer[32];
+	auto [end, error] = to_chars(buffer, buffer + sizeof(buffer), value);
+	out.append(buffer, end);
+}
+
+void appendJsonString(string& out, const string& value)
+{
+	static const char hexDigits[] = "0123456789abcdef";
+	out += '"';
+	for (char c : value) {
+		if (c == '"' || c == '\\') {
+			out += '\\';
+			out += c;
+		} else if (static_cast<unsigned char>(c) < 0x20) {
+			out += "\\u00";
+			out += hexDigits[c >> 4];
+			out += hexDigits[c & 0xF];
+		} else {
+			out += c;
+		}
+	}
+	out += '"';
+}
+
+void appendCsvField(string& out, const string& value)
+{
+	// Quotes are only needed if the field contains a separator, a quote or a line break
+	if (value.find_first_of(",\"\r\n") == string::npos) {
+		out += value;
+		return;
+	}
+	out += '"';
+	for (char c : value) {
+		if (c == '"')
+			out += '"';
+		out += c;
+	}
+	out += '"';
+}
+
+}
+
+CompanyReportWriter::CompanyReportWriter(Format format, unsigned nThreads)
+	: format_(format), nThreads_(max(nThreads, 1u))
+{
+}
+
+CompanyReportWriter::Format CompanyReportWriter::getFormat() const
+{
+	return format_;
+}
+
+unsigned CompanyReportWriter::getNumberThreads() const
+{
+	return nThreads_;
+}
+
+void CompanyReportWriter::setFormat(Format format)
+{
+	format_ = format;
+}
+
+void CompanyReportWriter::setNumberThreads(unsigned nThreads)
+{
+	nThreads_ = max(nThreads, 1u);
+}
+
+void CompanyReportWriter::write(const Company& company, int fileDescriptor)
+{
+	int nEmployees = company.getNumberEmployees();
+	int nChunks = clamp<int>((nEmployees + minRowsPerThread - 1) / minRowsPerThread, 1, nThreads_);
+
+	buffer_.clear();
+	appendHeader(buffer_, company);
+
+	if (nChunks == 1) {
+		appendRows(buffer_, company, 0, nEmployees, fileDescriptor);
+	} else {
+		/* The first chunk is formatted by this thread while the others are
+		 * formatted by workers, then all of them are written in order
+		 */
+		auto chunkStart = [&](int chunk) { return int(int64_t(nEmployees) * chunk / nChunks); };
+		vector<string> chunks(nChunks);
+		vector<jthread> workers;
+		for (int i = 1; i < nChunks; i++)
+			workers.emplace_back([&, i] { appendRows(chunks[i], company, chunkStart(i), chunkStart(i + 1)); });
+
+		appendRows(buffer_, company, 0, chunkStart(1), fileDescriptor);
+		for (int i = 1; i < nChunks; i++) {
+			workers[i - 1].join();
+			writeAll(fileDescriptor, buffer_, writeErrorMessage);
+			buffer_ = move(chunks[i]);
+		}
+	}
+
+	appendFooter(buffer_, company);
+	writeAll(fileDescriptor, buffer_, writeErrorMessage);
+	buffer_.clear();
+}
+
+void CompanyReportWriter::write(const Company& company, const string& filename)
+{
+	int fileDescriptor = openForWriting(filename);
+	try {
+		write(company, fileDescriptor);
+	} catch (...) {
+		closeFile(fileDescriptor);
+		throw;
+	}
+	closeFile(fileDescriptor);
+}
+
+string CompanyReportWriter::format(const Company& company) const
+{
+	string out;
+	appendHeader(out, company);
+	appendRows(out, company, 0, company.getNumberEmployees());
+	appendFooter(out, company);
+	return out;
+}
+
+void CompanyReportWriter::appendHeader(string& out, const Company& company) const
+{
+	switch (format_) {
+	case Format::text:
+		out += "This is the company ";
+		out += company.getName();
+		out += " presided by ";
+		out += company.getPresident()->getName();
+		out += '\n';
+		if (company.hasEmployees()) {
+			out += "This company has ";
+			appendInt(out, company.getNumberEmployees());
+			out += " employee(s): ";
+		} else {
+			out += "This company does not have any employees.";
+		}
+		break;
+	case Format::csv:
+		out += "index,name,salary\n";
+		break;
+	case Format::json:
+		out += "{\"name\":";
+		appendJsonString(out, company.getName());
+		out += ",\"president\":";
+		appendJsonString(out, company.getPresident()->getName());
+		out += ",\"employees\":[";
+		break;
+	}
+}
+
+void CompanyReportWriter::appendRows(string& out, const Company& company, int first, int last, int fileDescriptor) const
+{
+	for (int i = first; i < last; i++) {
+		// Only one lookup and one (virtual, allocating) call of each getter per row
+		Employee* employee = company.getEmployee(i);
+		string name = employee->getName();
+		double salary = employee->getSalary();
+
+		switch (format_) {
+		case Format::text:
+			out += "\n - Employee ";
+			appendInt(out, i);
+			out += ": ";
+			out += name;
+			out += ", paid $";
+			appendStreamDouble(out, salary);
+			break;
+		case Format::csv:
+			appendInt(out, i);
+			out += ',';
+			appendCsvField(out, name);
+			out += ',';
+			appendExactDouble(out, salary);
+			out += '\n';
+			break;
+		case Format::json:
+			// The separator is written before each row but the first, so chunks can be formatted independently
+			out += i == 0 ? "\n" : ",\n";
+			out += "{\"index\":";
+			appendInt(out, i);
+			out += ",\"name\":";
+			appendJsonString(out, name);
+			out += ",\"salary\":";
+			// JSON has no representation for infinities and NaN
+			if (isfinite(salary))
+				appendExactDouble(out, salary);
+			else
+				out += "null";
+			out += '}';
+			break;
+		}
+
+		if (fileDescriptor >= 0 && out.size() >= flushThreshold) {
+			writeAll(fileDescriptor, out, writeErrorMessage);
+			out.clear();
+		}
+	}
+}
+
+void CompanyReportWriter::appendFooter(string& out, const Company& company) const
+{
+	switch (format_) {
+	case Format::text:
+	case Format::csv:
+		break;
+	case Format::json:
+		out += company.hasEmployees() ? "\n]}" : "]}";
+		break;
+	}
+	if (format_ != Format::csv)
+		out += '\n';
+}
+
+}
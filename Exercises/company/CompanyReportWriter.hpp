@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <string>
+using namespace std;
+
+#include "Company.hpp"
+
+
+namespace company {
+
+/**
+ * @brief The CompanyReportWriter class, to dump a company (name, president and employees) as text, CSV or JSON.
+ * Rows are formatted with to_chars into a large reusable buffer that is written in big chunks to a file descriptor,
+ * instead of one flushed stream insertion per value. The text format is the same as operator<<.
+ */
+class CompanyReportWriter
+{
+public:
+	/**
+	 * @brief The Format enum, the available report formats
+	 */
+	enum class Format { text, csv, json };
+
+	/**
+	 * @brief flushThreshold Size (in bytes) of the buffer after which it is written out
+	 */
+	static inline const size_t flushThreshold = 1 << 20;
+	/**
+	 * @brief minRowsPerThread Minimal number of rows formatted by each thread in multithreaded mode
+	 */
+	static inline const int minRowsPerThread = 4096;
+
+	// Constructors
+	/**
+	 * @brief CompanyReportWriter Constructor receiving the report format and the number of formatting threads
+	 * @param format The report format (default: text)
+	 * @param nThreads The number of threads that format rows in parallel (default: 1, no extra thread)
+	 */
+	CompanyReportWriter(Format format = Format::text, unsigned nThreads = 1);
+
+	// Getters
+	/**
+	 * @brief getFormat To get the report format
+	 * @return The report format
+	 */
+	Format getFormat() const;
+	/**
+	 * @brief getNumberThreads To get the number of formatting threads
+	 * @return The number of formatting threads
+	 */
+	unsigned getNumberThreads() const;
+
+	// Setters
+	/**
+	 * @brief setFormat To change the report format
+	 * @param format The new report format
+	 */
+	void setFormat(Format format);
+	/**
+	 * @brief setNumberThreads To change the number of formatting threads.
+	 * Chunks of rows are formatted in parallel, then written in order.
+	 * @param nThreads The new number of formatting threads (0 is treated as 1)
+	 */
+	void setNumberThreads(unsigned nThreads);
+
+	// Writers
+	/**
+	 * @brief write To write the report of a company to an open file descriptor
+	 * @param company The company to report
+	 * @param fileDescriptor The file descriptor to write to (ex. 1 for the standard output)
+	 * @throw system_error If a write fails
+	 */
+	void write(const Company& company, int fileDescriptor);
+	/**
+	 * @brief write To write the report of a company to a file, created or truncated
+	 * @param company The company to report
+	 * @param filename The name of the file to write
+	 * @throw system_error If the file can't be opened or written
+	 */
+	void write(const Company& company, const string& filename);
+	/**
+	 * @brief format To get the report of a company as a string
+	 * @param company The company to report
+	 * @return The formatted report
+	 */
+	string format(const Company& company) const;
+
+private:
+	// Attributes
+	/**
+	 * @brief format_ To store the report format
+	 */
+	Format format_;
+	/**
+	 * @brief nThreads_ To store the number of formatting threads
+	 */
+	unsigned nThreads_;
+	/**
+	 * @brief buffer_ To store the formatted rows until they are written, reused between reports
+	 */
+	string buffer_;
+
+	/**
+	 * @brief appendHeader To format what comes before the employees rows
+	 * @param out The buffer to append to
+	 * @param company The company to report
+	 */
+	void appendHeader(string& out, const Company& company) const;
+	/**
+	 * @brief appendRows To format the rows of the employees with an index in [first, last[
+	 * @param out The buffer to append to
+	 * @param company The company to report
+	 * @param first The index of the first employee to format
+	 * @param last The index after the last employee to format
+	 * @param fileDescriptor If not negative, the buffer is written out to this file descriptor whenever it gets bigger than flushThreshold
+	 */
+	void appendRows(string& out, const Company& company, int first, int last, int fileDescriptor = -1) const;
+	/**
+	 * @brief appendFooter To format what comes after the employees rows
+	 * @param out The buffer to append to
+	 * @param company The company to report
+	 */
+	void appendFooter(string& out, const Company& company) const;
+};
+
+}
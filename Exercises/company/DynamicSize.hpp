@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+using namespace std;
+
+namespace company {
+
+/* Estimates of the memory allocated by the standard containers, used by the
+ * memoryFootprint() reports. They don't include the bookkeeping of the allocator
+ * (usually 8 to 16 bytes per allocation), so the real usage is a bit higher.
+ */
+
+/**
+ * @brief dynamicSize To estimate the memory allocated by a string
+ * @param text The string
+ * @return The bytes allocated, 0 if the string fits in the small string buffer
+ */
+inline size_t dynamicSize(const string& text)
+{
+	return text.capacity() > string().capacity() ? text.capacity() + 1 : 0;
+}
+
+/**
+ * @brief dynamicSize To estimate the memory allocated by a vector (not by its elements)
+ * @param values The vector
+ * @return The bytes allocated
+ */
+template <typename T>
+size_t dynamicSize(const vector<T>& values)
+{
+	return values.capacity() * sizeof(T);
+}
+
+/**
+ * @brief dynamicSize To estimate the memory allocated by a hash table (not by its elements)
+ * @param table The hash table
+ * @return The bytes allocated: the buckets, and one node per element with two pointers
+ * (the links of the node, or a link and the cached hash, depending on the library)
+ */
+template <typename K, typename V, typename H, typename E>
+size_t dynamicSize(const unordered_map<K, V, H, E>& table)
+{
+	return table.bucket_count() * sizeof(void*) + table.size() * (sizeof(pair<const K, V>) + 2 * sizeof(void*));
+}
+
+}
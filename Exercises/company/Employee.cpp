@@ -31,27 +31,98 @@
  * Version: 14/1.0
  */
 
+#include <algorithm>
+using namespace std;
+
 #include "Employee.hpp"
+#include "DynamicSize.hpp"
 
 namespace company {
 
 Employee::Employee(string name, double salary)
-    : name_(name), salary_(salary)
+    : name_(name), salaryCents_(toCents(salary))
+{
+}
+
+Employee::Employee(const Employee& employee)
+    : name_(employee.name_), salaryCents_(employee.salaryCents_)
 {
 }
 
 Employee::~Employee()
 {
+	// An observer may remove itself from the list while it is notified
+	vector<EmployeeObserver*> observers = observers_;
+	for (EmployeeObserver* observer : observers) {
+		observer->onEmployeeDestroyed(this);
+	}
+}
+
+Employee& Employee::operator=(const Employee& employee)
+{
+	if (this != &employee) {
+		name_ = employee.name_;
+		setSalaryCents(employee.salaryCents_);
+	}
+	return *this;
 }
 
 double Employee::getSalary() const
 {
-	return salary_;
+	return toDollars(getSalaryCents());
+}
+
+Cents Employee::getSalaryCents() const
+{
+	return salaryCents_;
+}
+
+Cents Employee::getBaseSalaryCents() const
+{
+	return salaryCents_;
 }
 
 void Employee::setSalary(double salary)
 {
-	salary_ = salary;
+	setSalaryCents(toCents(salary));
+}
+
+void Employee::setSalaryCents(Cents salary)
+{
+	Cents oldSalary = getSalaryCents();
+	salaryCents_ = salary;
+	onSalaryChanged();
+	notifySalaryChanged(oldSalary);
+}
+
+void Employee::addObserver(EmployeeObserver* observer)
+{
+	observers_.push_back(observer);
+}
+
+void Employee::removeObserver(EmployeeObserver* observer)
+{
+	auto it = find(observers_.begin(), observers_.end(), observer);
+	if (it != observers_.end()) {
+		observers_.erase(it);
+	}
+}
+
+void Employee::onSalaryChanged()
+{
+}
+
+void Employee::notifySalaryChanged(Cents oldSalary)
+{
+	Cents newSalary = getSalaryCents();
+	if (newSalary == oldSalary) {
+		return;
+	}
+	// An observer may add or remove observers while it is notified
+	vector<EmployeeObserver*> observers = observers_;
+	for (EmployeeObserver* observer : observers) {
+		observer->onEmployeeSalaryChanged(this, oldSalary, newSalary);
+	}
 }
 
 string Employee::getName() const
@@ -59,4 +130,14 @@ string Employee::getName() const
 	return name_;
 }
 
+Role Employee::getRole() const
+{
+	return Role::employee;
+}
+
+size_t Employee::memoryFootprint() const
+{
+	return sizeof(Employee) + dynamicSize(name_) + dynamicSize(observers_);
+}
+
 }
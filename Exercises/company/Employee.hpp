@@ -34,10 +34,23 @@
 #pragma once
 
 #include <string>
+#include <vector>
 using namespace std;
 
+#include "EmployeeObserver.hpp"
+#include "Money.hpp"
+
 namespace company {
 
+/**
+ * @brief Role The kind of an employee, used to group the payroll statistics
+ */
+enum class Role { employee, manager, secretary };
+/**
+ * @brief numberRoles The number of values of Role
+ */
+inline constexpr int numberRoles = 3;
+
 /**
  * @brief The Employee class to describe an employee
  */
@@ -51,22 +64,54 @@ public:
 	 * @param salary The employee salary (default: 0)
 	 */
 	Employee(string name = "unknown", double salary = 0);
+	/**
+	 * @brief Employee Copy constructor, the observers of the employee are not copied
+	 * @param employee The employee to copy
+	 */
+	Employee(const Employee& employee);
     /**
-     * @brief ~Employee The destructor
+     * @brief ~Employee The destructor, notifies the observers that the employee is destroyed
      */
     virtual ~Employee();
 
+	/**
+	 * @brief operator= To copy the name and the salary of another employee (but not its observers)
+	 * @param employee The employee to copy
+	 */
+	Employee& operator=(const Employee& employee);
+
 	// Getters
 	/**
-	 * @brief getSalary To get the employee salary
-	 * @return The employee salary
+	 * @brief getSalary To get the employee salary, kept for compatibility (see getSalaryCents)
+	 * @return The employee salary in dollars
 	 */
 	virtual double getSalary() const;
+	/**
+	 * @brief getSalaryCents To get the effective employee salary (including bonuses for the
+	 * subclasses that have them), precomputed and exact
+	 * @return The employee salary in cents
+	 */
+	virtual Cents getSalaryCents() const;
+	/**
+	 * @brief getBaseSalaryCents To get the employee salary before any bonus
+	 * @return The base salary in cents
+	 */
+	Cents getBaseSalaryCents() const;
 	/**
 	 * @brief getName To get the employee name
 	 * @return The employee name
 	 */
 	virtual string getName() const;
+	/**
+	 * @brief getRole To get the kind of the employee
+	 * @return The role of the employee
+	 */
+	virtual Role getRole() const;
+	/**
+	 * @brief memoryFootprint To estimate the memory used by the employee
+	 * @return The bytes of the object and of what it allocated
+	 */
+	virtual size_t memoryFootprint() const;
 
 	// Setters
 	/**
@@ -74,6 +119,36 @@ public:
 	 * @param salary The new salary of the employee
 	 */
 	void setSalary(double salary);
+	/**
+	 * @brief setSalaryCents To change the employee salary
+	 * @param salary The new salary of the employee, in cents
+	 */
+	void setSalaryCents(Cents salary);
+
+	// Observers
+	/**
+	 * @brief addObserver To notify an observer of the changes of the employee. An observer
+	 * added twice is notified twice, and must be removed twice.
+	 * @param observer The observer to add
+	 */
+	void addObserver(EmployeeObserver* observer);
+	/**
+	 * @brief removeObserver To stop notifying an observer (once, if it was added many times)
+	 * @param observer The observer to remove
+	 */
+	void removeObserver(EmployeeObserver* observer);
+
+protected:
+	/**
+	 * @brief onSalaryChanged Called after each change of the base salary, so subclasses
+	 * can update what they precompute from it (does nothing by default)
+	 */
+	virtual void onSalaryChanged();
+	/**
+	 * @brief notifySalaryChanged To notify the observers if the effective salary changed
+	 * @param oldSalary The effective salary before the change, in cents
+	 */
+	void notifySalaryChanged(Cents oldSalary);
 
 private:
 	// Attributes
@@ -82,9 +157,13 @@ private:
 	 */
 	string name_;
 	/**
-	 * @brief salary_ To store the employee salary
+	 * @brief salaryCents_ To store the employee base salary, in cents
+	 */
+	Cents salaryCents_;
+	/**
+	 * @brief observers_ To store the observers notified of the changes of the employee
 	 */
-	double salary_;
+	vector<EmployeeObserver*> observers_;
 };
 
 }
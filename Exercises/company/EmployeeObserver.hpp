@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include "Money.hpp"
+
+namespace company {
+
+class Employee;
+
+/**
+ * @brief The EmployeeObserver class, the interface of the objects notified of the changes of an employee.
+ * An employee can have many observers (for example every company it belongs to and its manager).
+ */
+class EmployeeObserver
+{
+public:
+	/**
+	 * @brief ~EmployeeObserver The destructor
+	 */
+	virtual ~EmployeeObserver() = default;
+
+	/**
+	 * @brief onEmployeeSalaryChanged Called after the effective salary of an observed employee changed
+	 * (a new base salary, or a new bonus for a manager)
+	 * @param employee The employee whose salary changed
+	 * @param oldSalary The previous salary, in cents
+	 * @param newSalary The new salary, in cents
+	 */
+	virtual void onEmployeeSalaryChanged(Employee* employee, Cents oldSalary, Cents newSalary) = 0;
+	/**
+	 * @brief onEmployeeDestroyed Called when an observed employee is being destroyed. The observer
+	 * must forget the employee, and must not call anything on it but its address.
+	 * @param employee The employee being destroyed
+	 */
+	virtual void onEmployeeDestroyed(Employee* employee) = 0;
+};
+
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <system_error>
+using namespace std;
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "FileIo.hpp"
+
+namespace company {
+
+int openForWriting(const string& filename)
+{
+#ifdef _WIN32
+	int fileDescriptor = _open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+	int fileDescriptor = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+	if (fileDescriptor < 0)
+		throw system_error(errno, generic_category(), "Cannot open " + filename);
+	return fileDescriptor;
+}
+
+void closeFile(int fileDescriptor)
+{
+#ifdef _WIN32
+	_close(fileDescriptor);
+#else
+	close(fileDescriptor);
+#endif
+}
+
+void writeAll(int fileDescriptor, const string& data, const char* errorMessage)
+{
+	// Each system call may write less than asked, and the count is an int on Windows
+	static const size_t maxWriteSize = 1 << 30;
+	size_t written = 0;
+	while (written < data.size()) {
+		size_t toWrite = min(data.size() - written, maxWriteSize);
+#ifdef _WIN32
+		int result = _write(fileDescriptor, data.data() + written, unsigned(toWrite));
+#else
+		ssize_t result = ::write(fileDescriptor, data.data() + written, toWrite);
+#endif
+		if (result < 0) {
+			if (errno == EINTR)
+				continue;
+			throw system_error(errno, generic_category(), errorMessage);
+		}
+		written += size_t(result);
+	}
+}
+
+void syncFile(int fileDescriptor)
+{
+#ifdef _WIN32
+	int result = _commit(fileDescriptor);
+#else
+	int result = fsync(fileDescriptor);
+#endif
+	if (result != 0)
+		throw system_error(errno, generic_category(), "Cannot sync a file to disk");
+}
+
+void syncDirectoryOf(const string& filename)
+{
+#ifndef _WIN32
+	string directory = filesystem::path(filename).parent_path().string();
+	int fileDescriptor = open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+	if (fileDescriptor >= 0) {
+		fsync(fileDescriptor);
+		close(fileDescriptor);
+	}
+#else
+	(void)filename;
+#endif
+}
+
+}
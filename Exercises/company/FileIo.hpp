@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <string>
+using namespace std;
+
+namespace company {
+
+/* Thin wrappers around the file descriptors of the system (POSIX, or the
+ * equivalent functions of the C runtime on Windows), shared by the classes
+ * that write big files in large chunks. They throw system_error on failure.
+ */
+
+/**
+ * @brief openForWriting To create (or empty) a file and open it for writing
+ * @param filename The file to open
+ * @return The file descriptor
+ */
+int openForWriting(const string& filename);
+/**
+ * @brief closeFile To close a file descriptor
+ * @param fileDescriptor The file descriptor to close
+ */
+void closeFile(int fileDescriptor);
+/**
+ * @brief writeAll To write a whole buffer to a file descriptor, even if the system writes it in many parts
+ * @param fileDescriptor The file descriptor to write to
+ * @param data The buffer to write
+ * @param errorMessage The message of the exception thrown if the write fails
+ */
+void writeAll(int fileDescriptor, const string& data, const char* errorMessage);
+/**
+ * @brief syncFile To wait until what was written to a file is on the disk, not only in the cache
+ * of the system (fsync, or _commit on Windows)
+ * @param fileDescriptor The file descriptor to sync
+ */
+void syncFile(int fileDescriptor);
+/**
+ * @brief syncDirectoryOf To make durable the creation or renaming of a file, by syncing its
+ * directory (needed on POSIX, nothing to do on Windows). Errors are ignored.
+ * @param filename The file that was created or renamed
+ */
+void syncDirectoryOf(const string& filename);
+
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+using namespace std;
+
+namespace company {
+
+/**
+ * @brief The Fingerprint struct, a 128 bits hash of a group of objects (identified by their address).
+ * Fingerprints of elements are combined by addition (modulo 2^128), which doesn't depend on the order
+ * and can be undone by a subtraction, so the fingerprint of a group can be kept up to date in O(1)
+ * when elements are added or removed. Equal groups always have equal fingerprints; different groups
+ * have different ones except with a negligible probability.
+ */
+struct Fingerprint
+{
+	uint64_t high = 0;
+	uint64_t low = 0;
+
+	/**
+	 * @brief of To get the fingerprint of a single object
+	 * @param address The address of the object
+	 * @param salt A value mixed in the hash, for example the position of the object in a sequence
+	 * @return The fingerprint
+	 */
+	static Fingerprint of(const void* address, uint64_t salt = 0)
+	{
+		uint64_t value = uint64_t(uintptr_t(address));
+		uint64_t high = mix(value + salt * 0x9E37'79B9'7F4A'7C15);
+		return {high, mix(high ^ value ^ 0xD6E8'FEB8'6659'FD93)};
+	}
+
+	Fingerprint& operator+=(const Fingerprint& other)
+	{
+		low += other.low;
+		high += other.high + (low < other.low ? 1 : 0);
+		return *this;
+	}
+
+	Fingerprint& operator-=(const Fingerprint& other)
+	{
+		high -= other.high + (low < other.low ? 1 : 0);
+		low -= other.low;
+		return *this;
+	}
+
+	bool operator==(const Fingerprint& other) const = default;
+
+private:
+	// The finalizer of splitmix64, every bit of the result depends on every bit of the value
+	static uint64_t mix(uint64_t value)
+	{
+		value = (value ^ (value >> 30)) * 0xBF58'476D'1CE4'E5B9;
+		value = (value ^ (value >> 27)) * 0x94D0'49BB'1331'11EB;
+		return value ^ (value >> 31);
+	}
+};
+
+}
+
+/**
+ * @brief hash<company::Fingerprint> To use fingerprints as keys of unordered containers (caches)
+ */
+template <>
+struct std::hash<company::Fingerprint>
+{
+	size_t operator()(const company::Fingerprint& fingerprint) const noexcept
+	{
+		// The bits are already well mixed
+		return size_t(fingerprint.low ^ fingerprint.high);
+	}
+};
@@ -32,33 +32,48 @@
  */
 
 #include "Manager.hpp"
+#include "DynamicSize.hpp"
 
 namespace company {
 
 Manager::Manager()
 	: Employee(), bonus_(0)
 {
+	updateSalary();
+	setupManagedPayroll();
 }
 
 Manager::Manager(string name, double salary)
-	: Employee(name, salary), bonus_(15)
+	: Employee(name, salary), bonus_(toBasisPoints(15))
 {
+	updateSalary();
+	setupManagedPayroll();
 }
 
 Manager::Manager(string name, double salary, double bonus)
-	: Employee(name, salary), bonus_(bonus)
+	: Employee(name, salary), bonus_(toBasisPoints(bonus))
 {
+	updateSalary();
+	setupManagedPayroll();
 }
 
 string Manager::getName() const {
 	return Employee::getName() + " (Manager)";
 }
 
-double Manager::getSalary() const {
-	return Employee::getSalary() * (1 + (bonus_ / 100.0));
+Role Manager::getRole() const {
+	return Role::manager;
+}
+
+Cents Manager::getSalaryCents() const {
+	return salaryCents_;
 }
 
 double Manager::getBonus() const {
+	return toPercent(bonus_);
+}
+
+BasisPoints Manager::getBonusBasisPoints() const {
 	return bonus_;
 }
 
@@ -75,12 +90,52 @@ Employee* Manager::getEmployee(string name) const {
 	return nullptr;
 }
 
+const vector<Employee*>& Manager::getManagedEmployees() const {
+	return managedEmployees_;
+}
+
+const PayrollTracker& Manager::getManagedPayroll() const {
+	return managedPayroll_;
+}
+
+Cents Manager::getManagedSalaryCents() const {
+	return managedPayroll_.getTotalSalaryCents();
+}
+
+size_t Manager::memoryFootprint() const {
+	// The tracker is inside the object, so only what it allocated is added
+	return Employee::memoryFootprint() + (sizeof(Manager) - sizeof(Employee))
+	     + dynamicSize(managedEmployees_) + (managedPayroll_.memoryFootprint() - sizeof(PayrollTracker));
+}
+
 void Manager::setBonus(double bonus) {
+	setBonusBasisPoints(toBasisPoints(bonus));
+}
+
+void Manager::setBonusBasisPoints(BasisPoints bonus) {
+	Cents oldSalary = salaryCents_;
 	bonus_ = bonus;
+	updateSalary();
+	notifySalaryChanged(oldSalary);
+}
+
+void Manager::onSalaryChanged() {
+	updateSalary();
+}
+
+void Manager::updateSalary() {
+	salaryCents_ = addPercentage(getBaseSalaryCents(), bonus_);
+}
+
+void Manager::setupManagedPayroll() {
+	managedPayroll_.setDestroyedCallback([this](Employee* employee) {
+		erase(managedEmployees_, employee);
+	});
 }
 
 void Manager::addEmployee(Employee* employee) {
 	managedEmployees_.push_back(employee);
+	managedPayroll_.track(employee);
 }
 
 }
\ No newline at end of file
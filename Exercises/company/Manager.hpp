@@ -37,6 +37,7 @@
 #include <vector>
 
 #include "Employee.hpp"
+#include "PayrollTracker.hpp"
 using namespace std;
 
 namespace company {
@@ -73,21 +74,51 @@ public:
 	*/
 	virtual string getName() const;
 	/**
-	* @brief getSalary To get the salary of the manager
-	* @return The salary of the manager, including its bonus
+	* @brief getRole To get the kind of the employee
+	* @return Role::manager
 	*/
-	virtual double getSalary() const;
+	virtual Role getRole() const;
+	/**
+	* @brief getSalaryCents To get the salary of the manager
+	* @return The salary of the manager including its bonus, in cents (precomputed)
+	*/
+	virtual Cents getSalaryCents() const;
 	/**
 	* @brief getBonus To get the bonus of the manager
 	* @return The bonus of the manager (in percent)
 	*/
 	double getBonus() const;
 	/**
+	* @brief getBonusBasisPoints To get the bonus of the manager
+	* @return The bonus of the manager (in basis points, 1500 for 15%)
+	*/
+	BasisPoints getBonusBasisPoints() const;
+	/**
 	* @brief getEmployee To get an employee of the manager
 	* @param name The name of the employee to get
 	* @return The employee of that name, or a nullptr if not found
 	*/
 	Employee* getEmployee(string name) const;
+	/**
+	* @brief getManagedEmployees To get the employees managed by the manager
+	* @return The managed employees, in the order they were added
+	*/
+	const vector<Employee*>& getManagedEmployees() const;
+	/**
+	* @brief getManagedPayroll To get the running totals of the salaries of the managed employees
+	* @return The totals, per role and overall (kept up to date in O(1))
+	*/
+	const PayrollTracker& getManagedPayroll() const;
+	/**
+	* @brief getManagedSalaryCents To get the sum of the salaries of the managed employees
+	* @return The subtotal in cents
+	*/
+	Cents getManagedSalaryCents() const;
+	/**
+	* @brief memoryFootprint To estimate the memory used by the manager
+	* @return The bytes of the object and of what it allocated, including the list and totals of its employees
+	*/
+	virtual size_t memoryFootprint() const;
 
 	// Setters
 	/**
@@ -96,21 +127,49 @@ public:
 	*/
 	void setBonus(double bonus);
 	/**
+	* @brief setBonusBasisPoints To change the bonus of the manager
+	* @param bonus The new bonus (in basis points, 1500 for 15%)
+	*/
+	void setBonusBasisPoints(BasisPoints bonus);
+	/**
 	* @brief addEmployee To add an employee to the manager
 	* @param employee The employee to add
 	*/
 	void addEmployee(Employee* employee);	
 
+protected:
+	/**
+	* @brief onSalaryChanged To update the precomputed salary when the base salary changes
+	*/
+	virtual void onSalaryChanged();
+
 private:
 	// Attributes
 	/**
-	* @brief bonus_ To store the bonus of the manager
+	* @brief bonus_ To store the bonus of the manager, in basis points
 	*/
-	double bonus_;
+	BasisPoints bonus_;
+	/**
+	* @brief salaryCents_ To store the salary of the manager including its bonus, updated when the salary or the bonus changes
+	*/
+	Cents salaryCents_;
+
+	/**
+	* @brief updateSalary To recompute the salary including the bonus
+	*/
+	void updateSalary();
+	/**
+	* @brief setupManagedPayroll To forget the managed employees when they are destroyed
+	*/
+	void setupManagedPayroll();
 	/**
 	* @brief managedEmployees_ To store the employees managed by the manager
 	*/
 	vector<Employee*> managedEmployees_;
+	/**
+	* @brief managedPayroll_ To store the running totals of the salaries of the managed employees
+	*/
+	PayrollTracker managedPayroll_;
 };
 
 }
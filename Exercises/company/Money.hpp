@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+using namespace std;
+
+namespace company {
+
+/**
+ * @brief Cents An amount of money in cents. Integer sums are exact, so they give
+ * the same total in any order and with any number of threads (unlike doubles).
+ */
+using Cents = int64_t;
+/**
+ * @brief BasisPoints A percentage in hundredths of a percent (1500 = 15%)
+ */
+using BasisPoints = int64_t;
+
+/**
+ * @brief toCents To convert dollars to cents, rounded to the nearest cent
+ * @param dollars The amount in dollars
+ * @return The amount in cents
+ */
+inline Cents toCents(double dollars)
+{
+	return llround(dollars * 100.0);
+}
+
+/**
+ * @brief toDollars To convert cents to dollars
+ * @param cents The amount in cents
+ * @return The amount in dollars
+ */
+inline double toDollars(Cents cents)
+{
+	return double(cents) / 100.0;
+}
+
+/**
+ * @brief toBasisPoints To convert a percentage to basis points, rounded to the nearest one
+ * @param percent The percentage (15 for 15%)
+ * @return The percentage in basis points
+ */
+inline BasisPoints toBasisPoints(double percent)
+{
+	return llround(percent * 100.0);
+}
+
+/**
+ * @brief toPercent To convert basis points to a percentage
+ * @param basisPoints The percentage in basis points
+ * @return The percentage (15 for 15%)
+ */
+inline double toPercent(BasisPoints basisPoints)
+{
+	return double(basisPoints) / 100.0;
+}
+
+/**
+ * @brief addPercentage To compute amount * (1 + rate), rounded to the nearest cent (halves away from zero).
+ * Exact for amounts up to about 400 billion dollars with rates up to 100%.
+ * @param amount The amount in cents
+ * @param rate The rate to add, in basis points
+ * @return The increased amount in cents
+ */
+inline Cents addPercentage(Cents amount, BasisPoints rate)
+{
+	int64_t scaled = amount * (10'000 + rate);
+	// Integer division truncates toward zero, so adding half of the divisor with the same sign rounds halves away from zero
+	return (scaled + (scaled >= 0 ? 5'000 : -5'000)) / 10'000;
+}
+
+/**
+ * @brief The SquareSum class, an exact sum of squared amounts of cents. A square of cents
+ * doesn't fit in 64 bits once summed over a few employees, so it is kept on 128 bits.
+ * Adding and removing are exact, so the sum can be kept up to date in any order.
+ */
+class SquareSum
+{
+public:
+	/**
+	 * @brief add To add the square of an amount
+	 * @param amount The amount in cents
+	 */
+	void add(Cents amount)
+	{
+		add(amount, 1);
+	}
+	/**
+	 * @brief remove To remove the square of an amount previously added
+	 * @param amount The amount in cents
+	 */
+	void remove(Cents amount)
+	{
+		add(amount, -1);
+	}
+	/**
+	 * @brief add To add the square of an amount a number of times at once, in O(1)
+	 * @param amount The amount in cents
+	 * @param count The number of times to add it (negative to remove it)
+	 */
+	void add(Cents amount, int64_t count)
+	{
+		uint64_t magnitude = amount < 0 ? 0 - uint64_t(amount) : uint64_t(amount);
+		uint64_t times = count < 0 ? 0 - uint64_t(count) : uint64_t(count);
+		// (squareHigh*2^64 + squareLow) * times, modulo 2^128 like the sum itself
+		auto [squareHigh, squareLow] = multiply(magnitude, magnitude);
+		auto [high, low] = multiply(squareLow, times);
+		high += squareHigh * times;
+		if (count >= 0) {
+			low_ += low;
+			high_ += high + (low_ < low ? 1 : 0);
+		} else {
+			high_ -= high + (low_ < low ? 1 : 0);
+			low_ -= low;
+		}
+	}
+	/**
+	 * @brief operator+= To add another sum to this one
+	 * @param other The sum to add
+	 */
+	SquareSum& operator+=(const SquareSum& other)
+	{
+		low_ += other.low_;
+		high_ += other.high_ + (low_ < other.low_ ? 1 : 0);
+		return *this;
+	}
+	/**
+	 * @brief toDouble To get the sum, rounded to a double
+	 * @return The sum of the squares, in square cents
+	 */
+	double toDouble() const
+	{
+		return double(high_) * 18446744073709551616.0 + double(low_);
+	}
+
+	bool operator==(const SquareSum& other) const = default;
+
+private:
+	/**
+	 * @brief multiply To compute the 128 bits product of two 64 bits numbers, as its high and low halves
+	 * (on 32 bits halves, since MSVC has no 128 bits integer type)
+	 */
+	static pair<uint64_t, uint64_t> multiply(uint64_t a, uint64_t b)
+	{
+		uint64_t aHigh = a >> 32, aLow = a & 0xFFFF'FFFF;
+		uint64_t bHigh = b >> 32, bLow = b & 0xFFFF'FFFF;
+		uint64_t lowLow = aLow * bLow;
+		uint64_t lowHigh = aLow * bHigh;
+		uint64_t highLow = aHigh * bLow;
+		// The sum of the middle terms (at 2^32) and of the carry of lowLow fits in 64 bits
+		uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFF'FFFF) + (highLow & 0xFFFF'FFFF);
+		uint64_t low = (middle << 32) | (lowLow & 0xFFFF'FFFF);
+		uint64_t high = aHigh * bHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+		return {high, low};
+	}
+
+	uint64_t high_ = 0;
+	uint64_t low_ = 0;
+};
+
+}
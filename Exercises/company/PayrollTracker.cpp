@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#include <cmath>
+using namespace std;
+
+#include "PayrollTracker.hpp"
+#include "DynamicSize.hpp"
+
+namespace company {
+
+double PayrollTracker::Aggregate::getMean() const
+{
+	if (count == 0) {
+		return 0;
+	}
+	return double(total) / count;
+}
+
+double PayrollTracker::Aggregate::getStandardDeviation() const
+{
+	if (count == 0) {
+		return 0;
+	}
+	double mean = getMean();
+	// E[x^2] - E[x]^2, from the exact sums; rounding can make it slightly negative when all salaries are equal
+	double variance = sumOfSquares.toDouble() / count - mean * mean;
+	return variance > 0 ? sqrt(variance) : 0;
+}
+
+PayrollTracker::PayrollTracker()
+{
+}
+
+PayrollTracker::~PayrollTracker()
+{
+	clear();
+}
+
+PayrollTracker::Aggregate PayrollTracker::getAggregate() const
+{
+	Aggregate all;
+	for (const Aggregate& aggregate : aggregates_) {
+		all.count += aggregate.count;
+		all.total += aggregate.total;
+		all.sumOfSquares += aggregate.sumOfSquares;
+	}
+	return all;
+}
+
+const PayrollTracker::Aggregate& PayrollTracker::getAggregate(Role role) const
+{
+	return aggregates_[int(role)];
+}
+
+Cents PayrollTracker::getTotalSalaryCents() const
+{
+	Cents total = 0;
+	for (const Aggregate& aggregate : aggregates_) {
+		total += aggregate.total;
+	}
+	return total;
+}
+
+bool PayrollTracker::isTracked(Employee* employee) const
+{
+	return tracked_.contains(employee);
+}
+
+size_t PayrollTracker::memoryFootprint() const
+{
+	return sizeof(PayrollTracker) + dynamicSize(tracked_);
+}
+
+void PayrollTracker::track(Employee* employee)
+{
+	auto [it, isNew] = tracked_.try_emplace(employee, TrackedEmployee{employee->getRole(), employee->getSalaryCents(), 0});
+	if (isNew) {
+		// Observed once, however many times it is tracked
+		employee->addObserver(this);
+	}
+	it->second.count++;
+	add(it->second.role, it->second.salary, 1);
+}
+
+void PayrollTracker::untrack(Employee* employee)
+{
+	auto it = tracked_.find(employee);
+	if (it == tracked_.end()) {
+		return;
+	}
+	add(it->second.role, it->second.salary, -1);
+	if (--it->second.count == 0) {
+		employee->removeObserver(this);
+		tracked_.erase(it);
+	}
+}
+
+void PayrollTracker::reserve(size_t nEmployees)
+{
+	tracked_.reserve(nEmployees);
+}
+
+void PayrollTracker::clear()
+{
+	for (auto&& [employee, tracked] : tracked_) {
+		employee->removeObserver(this);
+	}
+	tracked_.clear();
+	aggregates_ = {};
+}
+
+void PayrollTracker::setSalaryChangedCallback(function<void(Employee*)> callback)
+{
+	salaryChanged_ = move(callback);
+}
+
+void PayrollTracker::setDestroyedCallback(function<void(Employee*)> callback)
+{
+	destroyed_ = move(callback);
+}
+
+void PayrollTracker::onEmployeeSalaryChanged(Employee* employee, Cents, Cents newSalary)
+{
+	auto it = tracked_.find(employee);
+	if (it == tracked_.end()) {
+		return;
+	}
+	TrackedEmployee& tracked = it->second;
+	add(tracked.role, tracked.salary, -tracked.count);
+	tracked.salary = newSalary;
+	add(tracked.role, tracked.salary, tracked.count);
+	if (salaryChanged_) {
+		salaryChanged_(employee);
+	}
+}
+
+void PayrollTracker::onEmployeeDestroyed(Employee* employee)
+{
+	auto it = tracked_.find(employee);
+	if (it == tracked_.end()) {
+		return;
+	}
+	// The employee is going away, so there is no need to remove ourselves from its observers
+	add(it->second.role, it->second.salary, -it->second.count);
+	tracked_.erase(it);
+	if (destroyed_) {
+		destroyed_(employee);
+	}
+}
+
+void PayrollTracker::add(Role role, Cents salary, int count)
+{
+	Aggregate& aggregate = aggregates_[int(role)];
+	aggregate.count += count;
+	aggregate.total += salary * count;
+	aggregate.sumOfSquares.add(salary, count);
+}
+
+}
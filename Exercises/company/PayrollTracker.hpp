@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <unordered_map>
+using namespace std;
+
+#include "Employee.hpp"
+#include "EmployeeObserver.hpp"
+#include "Money.hpp"
+
+namespace company {
+
+/**
+ * @brief The PayrollTracker class, running payroll totals of a group of employees.
+ * It observes the employees it tracks, so the count, total and sum of squares of the salaries
+ * (per role and overall) are updated in O(1) when an employee is added, removed, or gets a new
+ * salary or bonus, instead of being recomputed from all the employees.
+ */
+class PayrollTracker : public EmployeeObserver
+{
+public:
+	/**
+	 * @brief The Aggregate struct, the running totals of a group of salaries
+	 */
+	struct Aggregate {
+		int       count = 0;
+		Cents     total = 0;
+		SquareSum sumOfSquares;
+
+		/**
+		 * @brief getMean To get the average salary
+		 * @return The average salary in cents, or 0 if there is no salary
+		 */
+		double getMean() const;
+		/**
+		 * @brief getStandardDeviation To get the (population) standard deviation of the salaries
+		 * @return The standard deviation in cents, or 0 if there is no salary
+		 */
+		double getStandardDeviation() const;
+	};
+
+	// Constructors
+	/**
+	 * @brief PayrollTracker The default constructor, tracking no employee
+	 */
+	PayrollTracker();
+	PayrollTracker(const PayrollTracker&) = delete;
+	/**
+	 * @brief ~PayrollTracker The destructor, stops observing the tracked employees
+	 */
+	virtual ~PayrollTracker();
+
+	PayrollTracker& operator=(const PayrollTracker&) = delete;
+
+	// Getters
+	/**
+	 * @brief getAggregate To get the totals of all the tracked employees
+	 * @return The totals over all the roles
+	 */
+	Aggregate getAggregate() const;
+	/**
+	 * @brief getAggregate To get the totals of the tracked employees of a role
+	 * @param role The role of the employees
+	 * @return The totals of that role
+	 */
+	const Aggregate& getAggregate(Role role) const;
+	/**
+	 * @brief getTotalSalaryCents To get the sum of the salaries of the tracked employees
+	 * @return The total in cents
+	 */
+	Cents getTotalSalaryCents() const;
+	/**
+	 * @brief isTracked To know if an employee is tracked
+	 * @param employee The employee to look for
+	 * @return Whether or not the employee is tracked
+	 */
+	bool isTracked(Employee* employee) const;
+	/**
+	 * @brief memoryFootprint To estimate the memory used by the tracker
+	 * @return The bytes of the object and of its hash table
+	 */
+	size_t memoryFootprint() const;
+
+	// Setters
+	/**
+	 * @brief track To add an employee to the totals. An employee tracked twice counts twice.
+	 * @param employee The employee to track
+	 */
+	void track(Employee* employee);
+	/**
+	 * @brief untrack To remove an employee from the totals (once, if it was tracked many times)
+	 * @param employee The employee to untrack
+	 */
+	void untrack(Employee* employee);
+	/**
+	 * @brief reserve To prepare for a number of different employees without rehashing
+	 * @param nEmployees The number of employees
+	 */
+	void reserve(size_t nEmployees);
+	/**
+	 * @brief clear To untrack all the employees
+	 */
+	void clear();
+	/**
+	 * @brief setSalaryChangedCallback To be called after the totals were updated for a new salary
+	 * @param callback The function to call with the employee whose salary changed
+	 */
+	void setSalaryChangedCallback(function<void(Employee*)> callback);
+	/**
+	 * @brief setDestroyedCallback To be called after a tracked employee that is being destroyed
+	 * was removed from the totals (with all its occurrences)
+	 * @param callback The function to call with the employee being destroyed
+	 */
+	void setDestroyedCallback(function<void(Employee*)> callback);
+
+	// EmployeeObserver
+	virtual void onEmployeeSalaryChanged(Employee* employee, Cents oldSalary, Cents newSalary);
+	virtual void onEmployeeDestroyed(Employee* employee);
+
+private:
+	/**
+	 * @brief The TrackedEmployee struct, what was added to the totals for an employee. It is kept
+	 * because a destroyed employee can't be asked its role or salary to remove them.
+	 */
+	struct TrackedEmployee {
+		Role  role;
+		Cents salary;
+		int   count;
+	};
+
+	/**
+	 * @brief add To add (or remove, with a negative count) a salary to the totals of a role
+	 */
+	void add(Role role, Cents salary, int count);
+
+	// Attributes
+	/**
+	 * @brief tracked_ To store the tracked employees
+	 */
+	unordered_map<Employee*, TrackedEmployee> tracked_;
+	/**
+	 * @brief aggregates_ To store the totals of each role
+	 */
+	array<Aggregate, numberRoles> aggregates_;
+	/**
+	 * @brief salaryChanged_ To store the function called after a salary change
+	 */
+	function<void(Employee*)> salaryChanged_;
+	/**
+	 * @brief destroyed_ To store the function called after a tracked employee is destroyed
+	 */
+	function<void(Employee*)> destroyed_;
+};
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#include "RosterSubscription.hpp"
+
+namespace company {
+
+void connectRoster(Company* company, QObject* receiver, RosterHandlers handlers)
+{
+	if (handlers.added) {
+		QObject::connect(company, &Company::employeeAdded, receiver, handlers.added);
+		// A merge sends one signal for all the employees it added at the end of the list
+		QObject::connect(company, &Company::employeesMerged, receiver, [company, added = handlers.added](int firstIndex, int count) {
+			for (int i = firstIndex; i < firstIndex + count; i++) {
+				added(company->getEmployee(i));
+			}
+		});
+	}
+	if (handlers.deleted) {
+		QObject::connect(company, &Company::employeeDeleted, receiver, move(handlers.deleted));
+	}
+	if (handlers.destroyed) {
+		QObject::connect(company, &Company::employeeDestroyed, receiver, move(handlers.destroyed));
+	}
+	if (handlers.salaryChanged) {
+		QObject::connect(company, &Company::employeeSalaryChanged, receiver, move(handlers.salaryChanged));
+	}
+	if (handlers.replaced) {
+		QObject::connect(company, &Company::rosterReplaced, receiver, move(handlers.replaced));
+	}
+}
+
+}
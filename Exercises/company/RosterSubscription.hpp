@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <functional>
+using namespace std;
+
+#include <QObject>
+
+#include "Company.hpp"
+
+
+namespace company {
+
+/**
+ * @brief The RosterHandlers struct, what a view of the employees of a company does on each
+ * change of the roster. The handlers left empty are not connected.
+ */
+struct RosterHandlers {
+	/**
+	 * @brief added To handle an employee added, one by one or by a merge
+	 */
+	function<void(Employee*)> added = nullptr;
+	/**
+	 * @brief deleted To handle one occurrence of an employee deleted
+	 */
+	function<void(Employee*)> deleted = nullptr;
+	/**
+	 * @brief destroyed To handle an employee in its destructor, all its occurrences dropped
+	 * (only its address and Employee::getName() can still be used)
+	 */
+	function<void(Employee*)> destroyed = nullptr;
+	/**
+	 * @brief salaryChanged To handle a change of the salary or of the bonus of an employee
+	 */
+	function<void(Employee*)> salaryChanged = nullptr;
+	/**
+	 * @brief replaced To handle the whole roster replaced by an assignment (operator=), after
+	 * which everything must be read again from the company
+	 */
+	function<void()> replaced = nullptr;
+};
+
+/**
+ * @brief connectRoster To keep a view of the employees of a company up to date from its signals
+ * @param company The company to follow
+ * @param receiver The owner of the connections, which are removed with it
+ * @param handlers What to do on each change
+ */
+void connectRoster(Company* company, QObject* receiver, RosterHandlers handlers);
+
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+#include "SalaryRanking.hpp"
+#include "RosterSubscription.hpp"
+
+namespace company {
+
+SalaryRanking::SalaryRanking(Company* company)
+	: company_(company)
+{
+	rebuild();
+	connectRoster(company, this, {
+		.added = [this](Employee* employee) { add(employee); },
+		.deleted = [this](Employee* employee) { remove(employee, false); },
+		.destroyed = [this](Employee* employee) { remove(employee, true); },
+		.salaryChanged = [this](Employee* employee) { updateSalary(employee); },
+		.replaced = [this]() { rebuild(); },
+	});
+}
+
+int SalaryRanking::getNumberEmployees() const
+{
+	return sizeOf(root_);
+}
+
+vector<Employee*> SalaryRanking::topK(int k) const
+{
+	vector<Employee*> top;
+	top.reserve(max(0, min(k, getNumberEmployees())));
+	// In-order traversal from the largest key: the right spine is stacked first
+	vector<int> path;
+	int node = root_;
+	while (int(top.size()) < k && (node != -1 || !path.empty())) {
+		if (node != -1) {
+			path.push_back(node);
+			node = nodes_[node].right;
+		} else {
+			node = path.back();
+			path.pop_back();
+			for (int i = 0; i < nodes_[node].count && int(top.size()) < k; i++) {
+				top.push_back(nodes_[node].employee);
+			}
+			node = nodes_[node].left;
+		}
+	}
+	return top;
+}
+
+Cents SalaryRanking::percentile(double p) const
+{
+	int n = getNumberEmployees();
+	if (n == 0) {
+		return 0;
+	}
+	// The r-th smallest salary, r being the nearest rank
+	int r = int(ceil(clamp(p, 0.0, 100.0) / 100.0 * n));
+	r = clamp(r, 1, n);
+	int node = root_;
+	while (true) {
+		int leftSize = sizeOf(nodes_[node].left);
+		if (r <= leftSize) {
+			node = nodes_[node].left;
+		} else if (r <= leftSize + nodes_[node].count) {
+			return nodes_[node].salary;
+		} else {
+			r -= leftSize + nodes_[node].count;
+			node = nodes_[node].right;
+		}
+	}
+}
+
+int SalaryRanking::rank(Employee* employee) const
+{
+	auto found = nodeIndices_.find(employee);
+	if (found == nodeIndices_.end()) {
+		return 0;
+	}
+	Cents salary = nodes_[found->second].salary;
+	int nPaidMore = 0;
+	int node = root_;
+	while (node != -1) {
+		if (nodes_[node].salary > salary) {
+			nPaidMore += sizeOf(nodes_[node].right) + nodes_[node].count;
+			node = nodes_[node].left;
+		} else {
+			node = nodes_[node].right;
+		}
+	}
+	return nPaidMore + 1;
+}
+
+void SalaryRanking::rebuild()
+{
+	nodes_.clear();
+	freeNodes_.clear();
+	nodeIndices_.clear();
+	root_ = -1;
+	nodes_.reserve(company_->getNumberEmployees());
+	nodeIndices_.reserve(company_->getNumberEmployees());
+	for (int i = 0; i < company_->getNumberEmployees(); i++) {
+		add(company_->getEmployee(i));
+	}
+}
+
+bool SalaryRanking::isBefore(int lhs, int rhs) const
+{
+	const Node& left = nodes_[lhs];
+	const Node& right = nodes_[rhs];
+	return left.salary < right.salary || (left.salary == right.salary && left.order < right.order);
+}
+
+int SalaryRanking::sizeOf(int node) const
+{
+	return node == -1 ? 0 : nodes_[node].size;
+}
+
+void SalaryRanking::update(int node)
+{
+	nodes_[node].size = sizeOf(nodes_[node].left) + nodes_[node].count + sizeOf(nodes_[node].right);
+}
+
+int SalaryRanking::insert(int root, int node)
+{
+	if (root == -1) {
+		return node;
+	}
+	// A child with a higher priority than its parent is rotated above it
+	if (isBefore(node, root)) {
+		int child = insert(nodes_[root].left, node);
+		nodes_[root].left = child;
+		if (nodes_[child].priority > nodes_[root].priority) {
+			nodes_[root].left = nodes_[child].right;
+			nodes_[child].right = root;
+			update(root);
+			update(child);
+			return child;
+		}
+	} else {
+		int child = insert(nodes_[root].right, node);
+		nodes_[root].right = child;
+		if (nodes_[child].priority > nodes_[root].priority) {
+			nodes_[root].right = nodes_[child].left;
+			nodes_[child].left = root;
+			update(root);
+			update(child);
+			return child;
+		}
+	}
+	update(root);
+	return root;
+}
+
+int SalaryRanking::erase(int root, int node)
+{
+	if (root == node) {
+		return merge(nodes_[node].left, nodes_[node].right);
+	}
+	if (isBefore(node, root)) {
+		nodes_[root].left = erase(nodes_[root].left, node);
+	} else {
+		nodes_[root].right = erase(nodes_[root].right, node);
+	}
+	update(root);
+	return root;
+}
+
+int SalaryRanking::merge(int left, int right)
+{
+	if (left == -1) {
+		return right;
+	}
+	if (right == -1) {
+		return left;
+	}
+	if (nodes_[left].priority > nodes_[right].priority) {
+		nodes_[left].right = merge(nodes_[left].right, right);
+		update(left);
+		return left;
+	}
+	nodes_[right].left = merge(left, nodes_[right].left);
+	update(right);
+	return right;
+}
+
+void SalaryRanking::changeCount(int node, int delta)
+{
+	// The key doesn't change, so only the sizes on the path to the node change
+	nodes_[node].count += delta;
+	int current = root_;
+	while (true) {
+		nodes_[current].size += delta;
+		if (current == node) {
+			return;
+		}
+		current = isBefore(node, current) ? nodes_[current].left : nodes_[current].right;
+	}
+}
+
+void SalaryRanking::add(Employee* employee)
+{
+	auto [it, isNew] = nodeIndices_.try_emplace(employee, -1);
+	if (!isNew) {
+		changeCount(it->second, 1);
+		return;
+	}
+
+	int node;
+	if (freeNodes_.empty()) {
+		node = int(nodes_.size());
+		nodes_.emplace_back();
+	} else {
+		node = freeNodes_.back();
+		freeNodes_.pop_back();
+	}
+	nodes_[node] = Node{employee->getSalaryCents(), nextOrder_++, employee, uint32_t(random_()), 1, 1, -1, -1};
+	it->second = node;
+	root_ = insert(root_, node);
+}
+
+void SalaryRanking::remove(Employee* employee, bool isAllRemoved)
+{
+	auto found = nodeIndices_.find(employee);
+	if (found == nodeIndices_.end()) {
+		return;
+	}
+	int node = found->second;
+	if (isAllRemoved || nodes_[node].count == 1) {
+		root_ = erase(root_, node);
+		freeNodes_.push_back(node);
+		nodeIndices_.erase(found);
+	} else {
+		changeCount(node, -1);
+	}
+}
+
+void SalaryRanking::updateSalary(Employee* employee)
+{
+	auto found = nodeIndices_.find(employee);
+	if (found == nodeIndices_.end()) {
+		return;
+	}
+	int node = found->second;
+	root_ = erase(root_, node);
+	nodes_[node].salary = employee->getSalaryCents();
+	nodes_[node].left = nodes_[node].right = -1;
+	update(node);
+	root_ = insert(root_, node);
+}
+
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2015    Raphaël Beamonte <raphael.beamonte@polymtl.ca>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file has been created for the purpose of the INF1010
+ * course of École Polytechnique de Montréal.
+ * Version: 14/1.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+#include <QObject>
+
+#include "Company.hpp"
+
+
+namespace company {
+
+/**
+ * @brief The SalaryRanking class, the employees of a company ordered by salary (including
+ * bonuses), for the top earners, percentiles and ranks of a compensation review.
+ *
+ * The employees are kept in a treap (a binary search tree balanced by random priorities) where
+ * each node knows the number of employees in its subtree. It is updated from the signals of the
+ * company in O(log n) (expected) on each addition, deletion and salary change, instead of
+ * sorting all the salaries for each question. An employee added many times counts many times.
+ */
+class SalaryRanking : public QObject
+{
+public:
+	// Constructors
+	/**
+	 * @brief SalaryRanking Constructor ranking the employees of a company, and following its changes
+	 * @param company The company to rank, it must outlive the ranking
+	 */
+	explicit SalaryRanking(Company* company);
+
+	// Getters
+	/**
+	 * @brief getNumberEmployees To get the number of ranked employees
+	 * @return The number of employees (an employee added twice counts twice)
+	 */
+	int getNumberEmployees() const;
+	/**
+	 * @brief topK To get the best paid employees, in O(k + log n)
+	 * @param k The number of employees
+	 * @return The k best paid employees (or all of them if there are fewer), best paid first
+	 */
+	vector<Employee*> topK(int k) const;
+	/**
+	 * @brief percentile To get a percentile of the salaries (nearest rank), in O(log n)
+	 * @param p The percentile, from 0 to 100 (50 for the median)
+	 * @return The smallest salary such that at least p% of the salaries are lower or equal, in cents (0 without employees)
+	 */
+	Cents percentile(double p) const;
+	/**
+	 * @brief rank To get the rank of an employee, in O(log n)
+	 * @param employee The employee
+	 * @return 1 + the number of employees paid more than it (equal salaries share a rank), or 0 if it isn't ranked
+	 */
+	int rank(Employee* employee) const;
+
+	// Setters
+	/**
+	 * @brief rebuild To rank again all the employees of the company
+	 */
+	void rebuild();
+
+private:
+	/**
+	 * @brief The Node struct, an employee in the treap, its key being (salary, order)
+	 */
+	struct Node {
+		Cents     salary;
+		uint64_t  order;    // Insertion order, so that equal salaries still give different keys
+		Employee* employee;
+		uint32_t  priority; // A node has a higher priority than its children
+		int       count;    // Number of occurrences of the employee in the company
+		int       size;     // Number of occurrences in the subtree
+		int       left;
+		int       right;
+	};
+
+	/**
+	 * @brief isBefore To compare the keys of two nodes
+	 */
+	bool isBefore(int lhs, int rhs) const;
+	/**
+	 * @brief sizeOf To get the size of a subtree (0 for an empty one)
+	 */
+	int sizeOf(int node) const;
+	/**
+	 * @brief update To recompute the size of a node from its children
+	 */
+	void update(int node);
+	/**
+	 * @brief insert To insert a node in a subtree
+	 * @return The new root of the subtree
+	 */
+	int insert(int root, int node);
+	/**
+	 * @brief erase To take a node out of a subtree (it isn't freed)
+	 * @return The new root of the subtree
+	 */
+	int erase(int root, int node);
+	/**
+	 * @brief merge To join two subtrees, all the keys of left being before those of right
+	 * @return The root of the joined subtree
+	 */
+	int merge(int left, int right);
+	/**
+	 * @brief changeCount To change the number of occurrences of a ranked employee
+	 */
+	void changeCount(int node, int delta);
+	/**
+	 * @brief add To rank one more occurrence of an employee
+	 */
+	void add(Employee* employee);
+	/**
+	 * @brief remove To unrank one (or all) of the occurrences of an employee
+	 */
+	void remove(Employee* employee, bool isAllRemoved);
+	/**
+	 * @brief updateSalary To move an employee after its salary changed
+	 */
+	void updateSalary(Employee* employee);
+
+	// Attributes
+	/**
+	 * @brief company_ To store the ranked company
+	 */
+	Company* company_;
+	/**
+	 * @brief nodes_ To store the nodes, referred to by their index (-1 for none)
+	 */
+	vector<Node> nodes_;
+	/**
+	 * @brief freeNodes_ To store the indices of the unused nodes of nodes_
+	 */
+	vector<int> freeNodes_;
+	/**
+	 * @brief root_ To store the root of the treap
+	 */
+	int root_ = -1;
+	/**
+	 * @brief nodeIndices_ To store the node of each ranked employee
+	 */
+	unordered_map<Employee*, int> nodeIndices_;
+	/**
+	 * @brief nextOrder_ To store the order of the next inserted node
+	 */
+	uint64_t nextOrder_ = 0;
+	/**
+	 * @brief random_ To generate the priorities of the nodes
+	 */
+	minstd_rand random_;
+};
+
+}
@@ -49,4 +49,8 @@ string Secretary::getName() const {
 	return Employee::getName() + " (Secretary)";
 }
 
+Role Secretary::getRole() const {
+	return Role::secretary;
+}
+
 }
\ No newline at end of file
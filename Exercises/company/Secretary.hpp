@@ -64,6 +64,11 @@ public:
 	* @return The name of the secretary, and its status (Secretary)
 	*/
 	virtual string getName() const;
+	/**
+	* @brief getRole To get the kind of the employee
+	* @return Role::secretary
+	*/
+	virtual Role getRole() const;
 };
 
 }
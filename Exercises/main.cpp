@@ -3,17 +3,41 @@
 #include <cstdint>
 
 #include <cassert>
+#include <cctype>
+#include <cmath>
+#include <chrono>
+#include <exception>
 #include <fstream>
+#include <iomanip>
 #include <filesystem>
+#include <mutex>
+#include <optional>
+#include <random>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include <QException>
 #include <QApplication>
 #include <QMessageBox>
 
 #include <view/CompanyWindow.hpp>
+#include <company/CompactRoster.hpp>
+#include <company/CompanyIndex.hpp>
+#include <company/CompanyJournal.hpp>
+#include <company/CompanyRegistry.hpp>
+#include <company/CompanyReportWriter.hpp>
+#include <company/Manager.hpp>
+#include <company/SalaryRanking.hpp>
+#include <company/Secretary.hpp>
 #include <utils/List.hpp>
+#include <utils/RingDeque.hpp>
+#include <utils/CommandFile.hpp>
+#include <utils/CommandReplay.hpp>
+#include <utils/ParseInt.hpp>
 #include <utils/MyClass.hpp>
+#include <utils/LatencyHistogram.hpp>
+#include <utils/ConcurrentQueue.hpp>
 
 using namespace std;
 using namespace utils;
@@ -51,7 +75,30 @@ int runQtExample(int argc, char* argv[]) {
 	return a.exec();
 }
 
-List<int> parseFile(const string& filename, bool printListEachStep = true) {
+// Ce que parseFile affiche pendant la lecture : rien, la liste au complet après chaque commande (O(n) par commande), ou seulement ce que chaque commande a changé (O(1) par commande).
+enum class ParseTrace { none, fullList, changes };
+
+// Les messages des commandes qui n'ont rien changé (voir applyCommand) : un pop sur une liste vide, ou un mot non reconnu.
+void printCommandError(ostream& os, const CommandEffect& effect, const string& x) {
+	if (effect.kind == CommandEffect::failedPop)
+		os << EmptyListError::popMessage << "\n";
+	else if (effect.kind == CommandEffect::unrecognized)
+		os << "Unrecognized value or command: " << x << "\n";
+}
+
+void printCommandEffect(ostream& os, const CommandEffect& effect) {
+	switch (effect.kind) {
+	case CommandEffect::pushedBack:  os << "push_back " << effect.value << "\n"; break;
+	case CommandEffect::poppedFront: os << "pop_front " << effect.value << "\n"; break;
+	case CommandEffect::poppedBack:  os << "pop_back " << effect.value << "\n"; break;
+	case CommandEffect::unrecognized:
+	case CommandEffect::failedPop:    break;
+	}
+}
+
+// Le conteneur est un paramètre : List<int> par défaut, ou RingDeque<int> qui est contigu (beaucoup moins de mémoire et des parcours plus rapides).
+template <typename Container = List<int>>
+Container parseFile(const string& filename, ParseTrace trace) {
 	// Ici, le but de l'exercice est de faire un programme qui construit une liste liée à partir de valeurs entières et de commandes dans un fichier.
 	// Les commandes sont "popf" et "popb" qui enlève le premier et le dernier élément de la liste, respectivement. Les valeurs et commandes sont séparées par des espaces.
 	// Par exemple, le fichier contenant "42 1337 69" fera la liste [42 1337 69]
@@ -63,34 +110,157 @@ List<int> parseFile(const string& filename, bool printListEachStep = true) {
 		return not(file.eof() or ws(file).eof());
 	};
 
-	List<int> values;
+	Container values;
 
 	try {
 		ifstream file(filename);
 		file.exceptions(ios::failbit);
 
-		if (printListEachStep)
+		if (trace != ParseTrace::none)
 			cout << values << "\n";
+		string x;
 		while (hasDataLeft(file)) {
-			try {
-				string x;
-				file >> x;
-				if (x == "popf")
+			file >> x;
+			CommandEffect effect = applyCommand(values, x);
+			printCommandError(cout, effect, x);
+			// On affiche la liste (ou seulement le changement) à chaque opération si demandé, sauf après un pop sur une liste vide (seul son message est affiché).
+			if (trace == ParseTrace::fullList and effect.kind != CommandEffect::failedPop)
+				cout << values << "\n";
+			else if (trace == ParseTrace::changes)
+				printCommandEffect(cout, effect);
+		}
+	} catch (ios::failure& e) {
+		cout << e.what() << "\n" << e.code() << "\n";
+	}
+
+	return values;
+}
+
+template <typename Container = List<int>>
+Container parseFile(const string& filename, bool printListEachStep = true) {
+	return parseFile<Container>(filename, printListEachStep ? ParseTrace::fullList : ParseTrace::none);
+}
+
+// Retourne la position du premier blanc à partir de 'position' (ou la fin du fichier), pour qu'un mot ne soit jamais coupé entre deux morceaux.
+size_t findTokenBoundary(const string& filename, size_t position, size_t fileSize) {
+	ifstream file(filename, ios::binary);
+	file.seekg(position);
+	while (position < fileSize and not isspace(file.get()))
+		position++;
+	return position;
+}
+
+// Version parallèle de parseFile (sans l'affichage à chaque étape), qui donne exactement la même liste et les mêmes messages.
+// Le fichier est découpé en morceaux (entre deux mots) analysés chacun par un fil d'exécution. Pour un morceau, on ne connaît pas la liste qu'il va recevoir, mais on peut la supposer assez longue et résumer son effet :
+//   - 'nPopFront' popf et 'nPopBack' popb enlèvent des éléments de la liste reçue (un popb n'y touche que si les valeurs ajoutées par le morceau sont déjà toutes enlevées);
+//   - les valeurs qui survivent sont ajoutées à la fin.
+// Ce résumé est exact si la liste reçue a au moins nPopFront + nPopBack éléments (aucun pop ne la trouve vide). Seule l'analyse des morceaux est parallèle : les résumés sont appliqués un à un, dans l'ordre, à la vraie liste.
+// Si la liste est trop courte, le résumé ne vaut rien (un pop aurait trouvé la liste vide, ou un popf aurait enlevé une valeur du morceau) et on relit simplement ce morceau de façon séquentielle.
+// Quand la plupart des morceaux se replieraient (pops presque aussi nombreux que les ajouts), la passe parallèle ne ferait que s'ajouter à la lecture séquentielle complète.
+// On l'estime donc avant de lancer les fils, sur un échantillon au début de chaque morceau, et on appelle alors directement parseFile.
+// Un résumé exact pour toute longueur de liste devrait aussi garder la position de chaque message de pop sur une liste vide parmi ceux des mots non reconnus, ce qui ne vaut pas la peine pour les fichiers visés (des pops minoritaires sur une longue liste).
+template <typename Container = List<int>>
+Container parseFileParallel(const string& filename, unsigned nThreads = thread::hardware_concurrency()) {
+	// En bas de cette taille, le coût des fils d'exécution dépasse le gain.
+	static constexpr size_t minChunkSize = 1 << 20;
+	// Taille de l'échantillon lu au début de chaque morceau pour estimer la proportion de pops.
+	static constexpr size_t sampleSize = 1 << 14;
+
+	struct ParsedChunk {
+		size_t         begin = 0;
+		size_t         end = 0;
+		size_t         nPopFront = 0;
+		size_t         nPopBack = 0;
+		Container      survivors;
+		vector<string> unrecognized;
+		exception_ptr  error;
+	};
+
+	Container values;
+
+	try {
+		// Pour avoir la même erreur que parseFile si le fichier n'existe pas.
+		ifstream(filename).exceptions(ios::failbit);
+
+		size_t fileSize = filesystem::file_size(filename);
+		size_t nChunks = clamp<size_t>(fileSize / minChunkSize, 1, max(nThreads, 1u));
+		vector<ParsedChunk> chunks(nChunks);
+		for (size_t i = 0; i < nChunks; i++) {
+			chunks[i].begin = i == 0 ? 0 : chunks[i - 1].end;
+			chunks[i].end = i == nChunks - 1 ? fileSize : max(chunks[i].begin, findTokenBoundary(filename, fileSize * (i + 1) / nChunks, fileSize));
+		}
+
+		// Après i morceaux, la liste a environ i * (nPushes - nPops) éléments (par morceau), et un morceau en enlève nPops : les nPops / (nPushes - nPops) premiers morceaux se replient.
+		// Si c'est plus de la moitié d'entre eux, on lit le fichier de façon séquentielle. (Tout mot autre qu'un pop compte comme un ajout : les mots non reconnus sont rares, et on évite de convertir les nombres.)
+		if (nChunks > 1) {
+			size_t nPushes = 0;
+			size_t nPops = 0;
+			for (const ParsedChunk& chunk : chunks) {
+				size_t sampleEnd = min(chunk.end, findTokenBoundary(filename, min(chunk.begin + sampleSize, fileSize), fileSize));
+				forEachToken(filename, chunk.begin, sampleEnd, [&] (const string& x, size_t) {
+					if (x == "popf" or x == "popb")
+						nPops++;
+					else
+						nPushes++;
+					return true;
+				});
+			}
+			if (nPushes <= nPops or nPops > (nPushes - nPops) * (nChunks / 2))
+				return parseFile<Container>(filename, ParseTrace::none);
+		}
+
+		// Déclaré après 'chunks', donc les fils sont arrêtés et attendus avant la destruction des morceaux (même si on sort par une exception).
+		vector<jthread> workers;
+		for (ParsedChunk& chunk : chunks) {
+			workers.emplace_back([&filename, &chunk, isFirst = &chunk == &chunks.front()] (stop_token stop) {
+				// Une exception de stoi (out_of_range) termine parseFile : on arrête le morceau là et on la relancera au bon moment.
+				try {
+					forEachToken(filename, chunk.begin, chunk.end, [&chunk, isFirst, &stop] (const string& x, size_t) {
+						// Le premier morceau part d'une liste vide connue, donc on l'applique directement (ses messages sont affichés avant ceux des autres morceaux, qu'on affiche seulement en les combinant).
+						if (isFirst)
+							printCommandError(cout, applyCommand(chunk.survivors, x), x);
+						else if (x == "popf")
+							chunk.nPopFront++;
+						else if (x == "popb") {
+							if (not chunk.survivors.try_pop_back())
+								chunk.nPopBack++;
+						} else if (optional<int> value = tryParseInt(x))
+							chunk.survivors.push_back(*value);
+						else
+							chunk.unrecognized.push_back(x);
+						// On arrête (sans erreur) si on demande l'arrêt du fil.
+						return not stop.stop_requested();
+					});
+				} catch (...) {
+					chunk.error = current_exception();
+				}
+			});
+		}
+
+		for (size_t i = 0; i < nChunks; i++) {
+			workers[i].join();
+			ParsedChunk& chunk = chunks[i];
+			if (values.size() >= chunk.nPopFront + chunk.nPopBack) {
+				// Aucun pop ne peut échouer, donc les seuls messages sont ceux des mots non reconnus.
+				for (const string& x : chunk.unrecognized)
+					printCommandError(cout, {CommandEffect::unrecognized}, x);
+				for (size_t j = 0; j < chunk.nPopFront; j++)
 					values.pop_front();
-				else if (x == "popb")
+				for (size_t j = 0; j < chunk.nPopBack; j++)
 					values.pop_back();
-				else {
-					try {
-						values.push_back(stoi(x, nullptr, 0));
-					} catch (invalid_argument& e) {
-						cout << "Unrecognized value or command: " << x << "\n";
-					}
-				}
-				// On affiche la liste à chaque opération si demandé.
-				if (printListEachStep)
-					cout << values << "\n";
-			} catch (EmptyListError& e) {
-				cout << e.what() << "\n";
+				// Avec une List, on relie les noeuds en O(1) au lieu de copier les valeurs.
+				if constexpr (requires { values.splice(values.end(), chunk.survivors); })
+					values.splice(values.end(), chunk.survivors);
+				else
+					for (int value : chunk.survivors)
+						values.push_back(value);
+				if (chunk.error)
+					rethrow_exception(chunk.error);
+			} else {
+				forEachToken(filename, chunk.begin, chunk.end, [&values] (const string& x, size_t) {
+					printCommandError(cout, applyCommand(values, x), x);
+					return true;
+				});
 			}
 		}
 	} catch (ios::failure& e) {
@@ -139,6 +309,355 @@ void runRaiiExample() {
 	}
 }
 
+void runConcurrentQueueBenchmark() {
+	// Chaque fil fait des paires push_back/pop_front (à la fois producteur et consommateur), avec un nombre total d'opérations fixe.
+	// On compare la file sans verrou à une List protégée par un mutex.
+	static constexpr int totalPairs = 2'000'000;
+
+	auto runThreads = [] (int nThreads, auto&& work) {
+		auto start = chrono::steady_clock::now();
+		vector<thread> threads;
+		for (int t = 0; t < nThreads; t++)
+			threads.emplace_back([&, t] { work(t, totalPairs / nThreads); });
+		for (auto& th : threads)
+			th.join();
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+		return 2.0 * totalPairs / elapsed.count() / 1e6;
+	};
+
+	cout << "threads  lock-free (Mops/s)  mutex+List (Mops/s)" << "\n";
+	for (int nThreads : {1, 2, 4, 8, 16, 32}) {
+		ConcurrentQueue<int> queue(4096);
+		double lockFree = runThreads(nThreads, [&] (int t, int nPairs) {
+			for (int i = 0; i < nPairs; i++) {
+				queue.push_back(t * nPairs + i);
+				// Un pop peut échouer temporairement si un producteur a réservé une case sans l'avoir encore remplie.
+				while (not queue.try_pop_front())
+					this_thread::yield();
+			}
+		});
+
+		mutex listMutex;
+		List<int> list;
+		double locked = runThreads(nThreads, [&] (int t, int nPairs) {
+			for (int i = 0; i < nPairs; i++) {
+				{
+					lock_guard lock(listMutex);
+					list.push_back(t * nPairs + i);
+				}
+				lock_guard lock(listMutex);
+				[[maybe_unused]] int value = *list.begin();
+				list.pop_front();
+			}
+		});
+
+		cout << setw(7) << nThreads << setw(20) << lockFree << setw(21) << locked << "\n";
+	}
+}
+
+void runListSortBenchmark(int nValues = 10'000'000) {
+	// On compare List::sort() (qui relie les noeuds) à l'approche classique : copier dans un vector, trier, puis recopier les valeurs dans la liste.
+	auto timeIt = [] (auto&& fn) {
+		auto start = chrono::steady_clock::now();
+		fn();
+		chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+		return elapsed.count();
+	};
+
+	mt19937 rng(42);
+	List<int> toSort;
+	for (int i = 0; i < nValues; i++)
+		toSort.push_back(int(rng()));
+	List<int> toCopy = toSort;
+
+	double sortTime = timeIt([&] { toSort.sort(); });
+	double copyTime = timeIt([&] {
+		vector<int> values;
+		values.reserve(toCopy.size());
+		for (int v : toCopy)
+			values.push_back(v);
+		stable_sort(values.begin(), values.end());
+		for (auto&& [e, v] : zip(toCopy, values))
+			e = v;
+	});
+
+	cout << nValues << " ints" << "\n"
+	     << "List::sort()            : " << sortTime << " ms" << "\n"
+	     << "vector + stable_sort    : " << copyTime << " ms" << "\n"
+	     << "Same result: " << boolalpha << (toSort == toCopy) << "\n";
+}
+
+void runParseFileBenchmark(int nTokens = 50'000'000) {
+	// Fichier de valeurs avec environ 30% de popf/popb et quelques mots non reconnus. On compare parseFile et parseFileParallel (temps et résultat).
+	auto timeIt = [] (auto&& fn) {
+		auto start = chrono::steady_clock::now();
+		fn();
+		chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+		return elapsed.count();
+	};
+
+	const string filename = "commands.txt";
+	{
+		mt19937 rng(42);
+		ofstream file(filename);
+		for (int i = 0; i < nTokens; i++) {
+			unsigned r = rng() % 100;
+			if (r < 15)
+				file << "popf ";
+			else if (r < 30)
+				file << "popb ";
+			else if (rng() % 1'000'000 == 0)
+				file << "henlo ";
+			else
+				file << int(rng() % 100'000) << " ";
+		}
+	}
+
+	List<int> sequential, parallel;
+	RingDeque<int> contiguous;
+	double sequentialTime = timeIt([&] { sequential = parseFile(filename, false); });
+	double parallelTime = timeIt([&] { parallel = parseFileParallel(filename); });
+	double contiguousTime = timeIt([&] { contiguous = parseFile<RingDeque<int>>(filename, false); });
+
+	// Un parcours complet de chaque conteneur, pour comparer la localité en mémoire.
+	long long listSum = 0, dequeSum = 0;
+	double listScanTime = timeIt([&] { for (int v : sequential) listSum += v; });
+	double dequeScanTime = timeIt([&] { for (int v : contiguous) dequeSum += v; });
+
+	cout << nTokens << " tokens, " << thread::hardware_concurrency() << " threads, " << sequential.size() << " values left" << "\n"
+	     << "parseFile()                 : " << sequentialTime << " ms" << "\n"
+	     << "parseFileParallel()         : " << parallelTime << " ms" << "\n"
+	     << "parseFile<RingDeque<int>>() : " << contiguousTime << " ms" << "\n"
+	     << "List scan                   : " << listScanTime << " ms" << "\n"
+	     << "RingDeque scan              : " << dequeScanTime << " ms" << "\n"
+	     << "Same result: " << boolalpha << (sequential == parallel and equal(sequential.begin(), sequential.end(), contiguous.begin(), contiguous.end()) and listSum == dequeSum) << "\n";
+	filesystem::remove(filename);
+}
+
+void runParseTraceBenchmark(int nCommands = 20'000) {
+	// Trace pas à pas d'un fichier de commandes, redirigée dans un fichier : la liste complète à chaque commande, puis seulement les changements.
+	// La trace complète est quadratique (déjà environ 600 Mo pour 20 000 commandes), donc on garde un petit nombre de commandes par défaut.
+	auto timeIt = [] (auto&& fn) {
+		auto start = chrono::steady_clock::now();
+		fn();
+		chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+		return elapsed.count();
+	};
+
+	const string filename = "trace_commands.txt";
+	{
+		mt19937 rng(42);
+		ofstream file(filename);
+		for (int i = 0; i < nCommands; i++)
+			file << (rng() % 10 == 0 ? "popf " : to_string(rng() % 1000) + " ");
+	}
+
+	auto timeTrace = [&] (ParseTrace trace, const string& traceFilename) {
+		ofstream traceFile(traceFilename);
+		auto* previousBuffer = cout.rdbuf(traceFile.rdbuf());
+		double elapsed = timeIt([&] { parseFile(filename, trace); });
+		cout.rdbuf(previousBuffer);
+		return elapsed;
+	};
+	double fullListTime = timeTrace(ParseTrace::fullList, "trace_full.txt");
+	double changesTime = timeTrace(ParseTrace::changes, "trace_changes.txt");
+
+	cout << nCommands << " commands" << "\n"
+	     << "ParseTrace::fullList : " << fullListTime << " ms (" << filesystem::file_size("trace_full.txt") << " bytes)" << "\n"
+	     << "ParseTrace::changes  : " << changesTime << " ms (" << filesystem::file_size("trace_changes.txt") << " bytes)" << "\n";
+	for (const char* f : {"trace_commands.txt", "trace_full.txt", "trace_changes.txt"})
+		filesystem::remove(f);
+}
+
+void runCommandReplayExample() {
+	// On indexe le fichier une fois (un point de reprise toutes les 3 commandes ici), puis on demande des états passés sans tout relire.
+	const string filename = "replay.txt";
+	ofstream(filename) << "1 42 69 popf 9000 popb popb popf popf henlo 42 0xBEEF 0xRAWR";
+
+	CommandReplay replay(filename, 3);
+	cout << replay.commandCount() << " commands, " << replay.checkpoints().size() << " checkpoints" << "\n";
+	for (size_t n : {0, 3, 5, 10, 13})
+		cout << "After " << n << " commands: " << replay.stateAfterCommand(n) << "\n";
+	cout << "At offset 20: " << replay.stateAtOffset(20) << "\n";
+	filesystem::remove(filename);
+}
+
+void runCompanyReportBenchmark(int nEmployees = 100'000) {
+	// On compare operator<< à CompanyReportWriter (un thread, puis tous les threads) pour une grosse compagnie.
+	using namespace company;
+	auto timeIt = [] (auto&& fn) {
+		auto start = chrono::steady_clock::now();
+		fn();
+		chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+		return elapsed.count();
+	};
+
+	// Les employés sont déclarés avant la compagnie pour lui survivre (sinon chaque destruction doit les retirer de la compagnie un à la fois).
+	vector<unique_ptr<Employee>> employees;
+	Company bigCompany("Big@Company", "Big Boss");
+	for (int i = 0; i < nEmployees; i++) {
+		employees.push_back(make_unique<Employee>("Employee " + to_string(i), 40'000 + i * 0.37));
+		bigCompany.addEmployee(employees.back().get());
+	}
+
+	double streamTime = timeIt([&] { ofstream("report_stream.txt") << bigCompany; });
+	CompanyReportWriter writer;
+	double writerTime = timeIt([&] { writer.write(bigCompany, string("report_text.txt")); });
+	writer.setNumberThreads(thread::hardware_concurrency());
+	double parallelTime = timeIt([&] { writer.write(bigCompany, string("report_parallel.txt")); });
+	writer.setFormat(CompanyReportWriter::Format::json);
+	double jsonTime = timeIt([&] { writer.write(bigCompany, string("report.json")); });
+
+	cout << nEmployees << " employees" << "\n"
+	     << "operator<<               : " << streamTime << " ms" << "\n"
+	     << "CompanyReportWriter      : " << writerTime << " ms" << "\n"
+	     << "CompanyReportWriter (MT) : " << parallelTime << " ms" << "\n"
+	     << "CompanyReportWriter JSON : " << jsonTime << " ms" << "\n";
+	for (const char* filename : {"report_stream.txt", "report_text.txt", "report_parallel.txt", "report.json"})
+		filesystem::remove(filename);
+}
+
+void runPayrollExample() {
+	// Les totaux de la paie sont mis à jour à chaque changement, donc les lire ne parcourt pas les employés.
+	using namespace company;
+	Employee alice("Alice", 52'000);
+	Manager bob("Bob", 80'000, 10);
+	Secretary carol("Carol", 41'000.50);
+	Company company("Polytechnique@Montreal", "Big Boss");
+	for (Employee* employee : {(Employee*)&alice, (Employee*)&bob, (Employee*)&carol})
+		company.addEmployee(employee);
+	bob.addEmployee(&alice);
+	bob.addEmployee(&carol);
+
+	auto printPayroll = [&] {
+		const PayrollTracker::Aggregate& managers = company.getPayroll().getAggregate(Role::manager);
+		PayrollTracker::Aggregate all = company.getPayroll().getAggregate();
+		cout << fixed << setprecision(2)
+		     << "Total: " << toDollars(all.total) << " $ for " << all.count << " employees"
+		     << " (mean " << toDollars(llround(all.getMean())) << " $, std dev " << toDollars(llround(all.getStandardDeviation())) << " $)" << "\n"
+		     << "Managers: " << toDollars(managers.total) << " $, managed by Bob: " << toDollars(bob.getManagedSalaryCents()) << " $" << "\n";
+		cout << defaultfloat;
+	};
+	printPayroll();
+	alice.setSalary(55'000);
+	bob.setBonus(15);
+	printPayroll();
+	company.delEmployee(&carol);
+	printPayroll();
+}
+
+void runCompanyJournalExample() {
+	// Les changements sont ajoutés au journal et écrits sur disque par groupes; on reconstruit ensuite la compagnie à partir du snapshot et du journal, comme après un plantage.
+	using namespace company;
+	const string snapshotFilename = "company_snapshot.bin";
+	const string journalFilename = "company_journal.bin";
+	{
+		Employee alice("Alice", 52'000);
+		Manager bob("Bob", 80'000, 10);
+		Company company("Polytechnique@Montreal", "Big Boss");
+		company.addEmployee(&alice);
+		CompanyJournal journal(&company, snapshotFilename, journalFilename);
+		company.addEmployee(&bob);
+		alice.setSalary(55'000);
+		bob.setBonus(15);
+		Employee newPresident("New Boss");
+		company.setPresident(&newPresident);
+		journal.sync();
+		cout << journal.getNumberRecords() << " records, " << journal.getNumberSyncs() << " syncs" << "\n";
+	}
+
+	CompanyJournal::Recovery recovery = CompanyJournal::recover(snapshotFilename, journalFilename);
+	cout << "Replayed " << recovery.nReplayedRecords << " records" << "\n"
+	     << *recovery.company << "\n";
+	filesystem::remove(snapshotFilename);
+	filesystem::remove(journalFilename);
+}
+
+void runCompanyRegistryExample() {
+	// Le registre indexe les employés de toutes ses compagnies par nom; l'index suit les ajouts, retraits et fusions des compagnies.
+	using namespace company;
+	Employee alice("Alice", 52'000);
+	Manager bob("Bob", 80'000, 10);
+	CompanyRegistry registry;
+	Company* poly = registry.createCompany("Polytechnique@Montreal", "Big Boss");
+	Company* udem = registry.createCompany("UdeM@Montreal", "Other Boss");
+	poly->addEmployee(&alice);
+	poly->addEmployee(&bob);
+	udem->addEmployee(&alice);
+	for (auto&& [company, employee] : registry.findByName("Alice"))
+		cout << employee->getName() << " works for " << company->getName() << "\n";
+	poly->delEmployee(&alice);
+	cout << registry.findByName("Alice").size() << " employment(s) left for Alice, "
+	     << registry.getNumberEmployments() << " in total" << "\n";
+}
+
+void runMemoryFootprintExample(int nEmployees = 100'000) {
+	// Mémoire utilisée par employé dans la compagnie (objets Employee séparés), comparée à un CompactRoster des mêmes employés (enregistrements de 16 octets).
+	using namespace company;
+	vector<unique_ptr<Employee>> employees;
+	Company bigCompany("Big@Company", "Big Boss");
+	Manager* manager = nullptr;
+	for (int i = 0; i < nEmployees; i++) {
+		if (i % 10 == 0) {
+			employees.push_back(make_unique<Manager>("Manager " + to_string(i), 80'000 + i * 0.37, 10));
+			manager = static_cast<Manager*>(employees.back().get());
+		}
+		else {
+			employees.push_back(make_unique<Employee>("Employee " + to_string(i), 40'000 + i * 0.37));
+			manager->addEmployee(employees.back().get());
+		}
+		bigCompany.addEmployee(employees.back().get());
+	}
+
+	Company::MemoryFootprint footprint = bigCompany.memoryFootprint();
+	cout << footprint.nEmployees << " employees" << "\n"
+	     << "Company       : " << footprint.getBytesPerEmployee() << " bytes/employee" << "\n"
+	     << "CompactRoster : " << footprint.getCompactBytesPerEmployee() << " bytes/employee" << "\n";
+}
+
+void runCompanyIndexExample(int nEmployees = 100'000) {
+	// Les gestionnaires qui gagnent entre 80k et 120k, trouvés par l'index des salaires (O(log n + k)) plutôt qu'en parcourant tous les employés.
+	using namespace company;
+	vector<unique_ptr<Employee>> employees;
+	Company bigCompany("Big@Company", "Big Boss");
+	CompanyIndex index(&bigCompany);
+	for (int i = 0; i < nEmployees; i++) {
+		if (i % 100 == 0)
+			employees.push_back(make_unique<Manager>("Manager " + to_string(i), 60'000 + i * 0.6, 10));
+		else
+			employees.push_back(make_unique<Employee>("Employee " + to_string(i), 40'000 + i * 0.37));
+		bigCompany.addEmployee(employees.back().get());
+	}
+
+	CompanyIndex::Query query{.role = Role::manager, .minSalary = toCents(80'000), .maxSalary = toCents(120'000),
+	                          .sortKey = CompanyIndex::SortKey::salary, .isDescending = true};
+	vector<Employee*> managers = index.find(query);
+	cout << managers.size() << " managers earning 80k-120k, the best paid: " << managers.front()->getName() << "\n";
+	for (const CompanyIndex::Group& group : index.group({.minSalary = toCents(70'000)}, CompanyIndex::GroupKey::role))
+		cout << group.employees.size() << " earning 70k or more with role " << int(group.role) << ", total " << toDollars(group.totalSalary) << "\n";
+}
+
+void runSalaryRankingExample(int nEmployees = 100'000) {
+	// Les meilleurs salaires, la médiane et le rang d'un employé restent à jour en O(log n) à chaque changement, sans trier tous les salaires.
+	using namespace company;
+	vector<unique_ptr<Employee>> employees;
+	Company bigCompany("Big@Company", "Big Boss");
+	SalaryRanking ranking(&bigCompany);
+	mt19937 random(42);
+	for (int i = 0; i < nEmployees; i++) {
+		employees.push_back(make_unique<Employee>("Employee " + to_string(i), 30'000 + random() % 100'000));
+		bigCompany.addEmployee(employees.back().get());
+	}
+
+	Employee* someone = employees[nEmployees / 2].get();
+	cout << "Median: " << toDollars(ranking.percentile(50)) << ", p90: " << toDollars(ranking.percentile(90)) << "\n"
+	     << someone->getName() << " is ranked " << ranking.rank(someone) << "\n";
+	someone->setSalary(200'000);
+	cout << "After a raise, " << someone->getName() << " is ranked " << ranking.rank(someone) << "\n";
+	for (Employee* employee : ranking.topK(3))
+		cout << employee->getName() << ": " << employee->getSalary() << "\n";
+}
+
 double fn1_assert(double x, double y) {
 	assert(x != y);
 	return (x+y)/(x-y);
@@ -250,4 +769,31 @@ int main(int argc, char* argv[]) {
 	//runRaiiExample();
 	
 	//runSimpleExceptExample();
+
+	//runConcurrentQueueBenchmark();
+
+	//runListSortBenchmark();
+
+	//runParseFileBenchmark();
+
+	//runParseTraceBenchmark();
+
+	//runCommandReplayExample();
+
+	//runCompanyReportBenchmark();
+
+	//runPayrollExample();
+
+	//runCompanyJournalExample();
+
+	//runCompanyRegistryExample();
+
+	//runMemoryFootprintExample();
+
+	//runCompanyIndexExample();
+
+	//runSalaryRankingExample();
+
+	// Avec UTILS_LATENCY_INSTRUMENTATION défini, affiche les p50/p99/p999 des opérations mesurées.
+	//LatencyRegistry::instance().printReport(cout);
 }
@@ -0,0 +1,93 @@
+#pragma once
+
+
+#pragma region "Includes" //{
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "ParseInt.hpp"
+
+using namespace std;
+
+#pragma endregion //}
+
+
+namespace utils {
+
+// Le format d'un fichier de commandes (celui de parseFile) : des entiers à ajouter à la fin de la liste et des commandes "popf"/"popb" qui enlèvent le premier et le dernier élément, séparés par des blancs.
+// La lecture des mots et l'effet de chaque commande sont ici, pour que parseFile, parseFileParallel et CommandReplay lisent un fichier exactement de la même façon.
+
+// Ce qu'une commande a changé dans la liste.
+// 'failedPop' est un pop sur une liste vide et 'unrecognized' un mot qui n'est ni un nombre ni une commande : la liste n'a pas changé, et c'est à l'appelant d'afficher un message s'il le veut.
+struct CommandEffect {
+	enum Kind { unrecognized, pushedBack, poppedFront, poppedBack, failedPop };
+	Kind kind = unrecognized;
+	int  value = 0;
+};
+
+// Applique une valeur ou une commande à la liste, sans rien afficher.
+// Les erreurs sont des cas normaux dans un fichier de commandes, donc on utilise les versions sans exception (try_pop_front, tryParseInt) : un fichier plein d'erreurs se lit aussi vite qu'un fichier valide.
+// Seul un nombre trop grand pour un int lance une exception (out_of_range, comme stoi), qui termine la lecture.
+template <typename Container>
+CommandEffect applyCommand(Container& values, const string& x) {
+	if (x == "popf") {
+		if (optional<int> value = values.try_pop_front())
+			return {CommandEffect::poppedFront, *value};
+		return {CommandEffect::failedPop};
+	} else if (x == "popb") {
+		if (optional<int> value = values.try_pop_back())
+			return {CommandEffect::poppedBack, *value};
+		return {CommandEffect::failedPop};
+	} else if (optional<int> value = tryParseInt(x)) {
+		values.push_back(*value);
+		return {CommandEffect::pushedBack, *value};
+	}
+	return {};
+}
+
+// Position de fin pour forEachToken : lire jusqu'à la fin du fichier.
+inline constexpr size_t endOfFile = numeric_limits<size_t>::max();
+
+// Appelle fn(mot, position juste après le mot) pour chaque mot (suite de caractères non blancs, comme avec 'file >> x') entre les positions 'begin' et 'end' du fichier, tant que fn retourne true.
+// Les positions doivent tomber entre deux mots. On lit par blocs pour ne jamais avoir tout le fichier en mémoire.
+template <typename Fn>
+void forEachToken(const string& filename, size_t begin, size_t end, Fn&& fn) {
+	static constexpr size_t blockSize = 1 << 20;
+
+	ifstream file(filename, ios::binary);
+	file.exceptions(ios::badbit);
+	if (not file)
+		throw ios::failure("Cannot open " + filename);
+	file.seekg(begin);
+
+	string block(blockSize, '\0');
+	string token;
+	size_t offset = begin;
+	while (offset < end and file) {
+		file.read(block.data(), min(blockSize, end - offset));
+		size_t blockLength = size_t(file.gcount());
+		for (size_t i = 0; i < blockLength; i++) {
+			if (not isspace(static_cast<unsigned char>(block[i])))
+				token += block[i];
+			else if (not token.empty()) {
+				if (not fn(as_const(token), offset + i))
+					return;
+				token.clear();
+			}
+		}
+		offset += blockLength;
+	}
+	if (not token.empty())
+		fn(as_const(token), offset);
+}
+
+}
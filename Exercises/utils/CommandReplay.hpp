@@ -0,0 +1,127 @@
+#pragma once
+
+
+#pragma region "Includes" //{
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "List.hpp"
+#include "CommandFile.hpp"
+
+using namespace std;
+
+#pragma endregion //}
+
+
+namespace utils {
+
+// Moteur de relecture d'un fichier de commandes (le format de parseFile : des entiers et des commandes "popf"/"popb" séparés par des blancs).
+// On lit le fichier une seule fois au complet en gardant à intervalle régulier des points de reprise : le nombre de commandes lues, la position dans le fichier et une copie compacte (un vector) des valeurs.
+// Ensuite, pour obtenir l'état après la N-ième commande ou à une position du fichier, on repart du point de reprise le plus proche qui précède et on ne relit que la fin.
+// Chaque mot compte comme une commande, même s'il n'est pas reconnu. Les mots et les commandes sont lus comme dans parseFile (voir CommandFile.hpp), mais la relecture n'affiche rien : un popf/popb sur une liste vide et un mot non reconnu sont ignorés.
+// Un nombre trop grand pour un int termine parseFile avec out_of_range; ici, on lance la même exception si on demande un état qui est après ce mot.
+template <typename Container = List<int>>
+class CommandReplay
+{
+public:
+	struct Checkpoint {
+		size_t      commandIndex = 0; // Nombre de commandes appliquées.
+		size_t      offset = 0;       // Position dans le fichier juste après la dernière commande appliquée.
+		vector<int> values;
+	};
+
+	// Lit tout le fichier et garde un point de reprise à toutes les 'checkpointInterval' commandes.
+	explicit CommandReplay(string filename, size_t checkpointInterval = 1'000'000)
+		: filename_(move(filename)),
+		  checkpointInterval_(max<size_t>(checkpointInterval, 1)) {
+		buildIndex();
+	}
+
+	const string& filename() const { return filename_; }
+	// Nombre de commandes lues avant la fin du fichier (ou avant le nombre trop grand qui termine la lecture).
+	size_t commandCount() const { return commandCount_; }
+	const vector<Checkpoint>& checkpoints() const { return checkpoints_; }
+
+	// État de la liste après les 'nCommands' premières commandes.
+	Container stateAfterCommand(size_t nCommands) const {
+		if (nCommands > commandCount_ and not stoppedByError_)
+			throw out_of_range("The command file has only " + to_string(commandCount_) + " commands.");
+
+		auto found = upper_bound(checkpoints_.begin(), checkpoints_.end(), nCommands,
+		                         [] (size_t n, const Checkpoint& c) { return n < c.commandIndex; });
+		const Checkpoint& start = *prev(found);
+		Container values = restore(start);
+		size_t commandIndex = start.commandIndex;
+		if (commandIndex < nCommands) {
+			forEachToken(filename_, start.offset, endOfFile, [&] (const string& x, size_t) {
+				applyCommand(values, x);
+				return ++commandIndex < nCommands;
+			});
+		}
+		return values;
+	}
+
+	// État de la liste après toutes les commandes qui se terminent avant la position 'offset' du fichier (pour reprendre la lecture à cette position).
+	Container stateAtOffset(size_t offset) const {
+		auto found = upper_bound(checkpoints_.begin(), checkpoints_.end(), offset,
+		                         [] (size_t o, const Checkpoint& c) { return o < c.offset; });
+		const Checkpoint& start = *prev(found);
+		Container values = restore(start);
+		forEachToken(filename_, start.offset, endOfFile, [&] (const string& x, size_t tokenEnd) {
+			if (tokenEnd > offset)
+				return false;
+			applyCommand(values, x);
+			return true;
+		});
+		return values;
+	}
+
+private:
+	void buildIndex() {
+		// On part du point de reprise de l'état vide au début du fichier, qui existe toujours.
+		checkpoints_.push_back({});
+		Container values;
+		try {
+			forEachToken(filename_, 0, endOfFile, [&] (const string& x, size_t tokenEnd) {
+				applyCommand(values, x);
+				commandCount_++;
+				if (commandCount_ % checkpointInterval_ == 0)
+					checkpoints_.push_back({commandCount_, tokenEnd, snapshot(values)});
+				return true;
+			});
+		} catch (out_of_range&) {
+			// On garde l'erreur pour la relancer (par stoi, en relisant) si on demande un état après ce mot.
+			stoppedByError_ = true;
+		}
+	}
+
+	static vector<int> snapshot(const Container& values) {
+		vector<int> result;
+		result.reserve(values.size());
+		for (int value : values)
+			result.push_back(value);
+		return result;
+	}
+
+	static Container restore(const Checkpoint& checkpoint) {
+		Container values;
+		for (int value : checkpoint.values)
+			values.push_back(value);
+		return values;
+	}
+
+	string             filename_;
+	size_t             checkpointInterval_;
+	vector<Checkpoint> checkpoints_;
+	size_t             commandCount_ = 0;
+	bool               stoppedByError_ = false;
+};
+
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+
+#pragma region "Includes" //{
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "List.hpp"
+
+using namespace std;
+
+#pragma endregion //}
+
+
+namespace utils {
+
+// File d'attente bornée multi-producteurs/multi-consommateurs sans verrou (algorithme de Dmitry Vyukov).
+// Les valeurs sont stockées dans un tampon circulaire alloué une seule fois, donc il n'y a aucune allocation ni libération de mémoire pendant l'utilisation, et le problème de récupération sécuritaire de la mémoire (ABA, pointeurs pendants) ne se pose pas.
+// Chaque case a un numéro de séquence qui indique si elle est prête à être écrite (séquence == position) ou lue (séquence == position + 1).
+// On garde le vocabulaire de List (push_back/pop_front) et pop_front() lance EmptyListError sur une file vide, comme List.
+// Si la construction d'une valeur lance une exception après la réservation de sa case, la case est publiée vide ("pierre tombale") et les consommateurs la sautent, sinon ils attendraient cette case indéfiniment.
+template <typename T>
+class ConcurrentQueue
+{
+public:
+	using value_type = T;
+
+	// La capacité est arrondie à la puissance de 2 supérieure pour remplacer le modulo par un masque.
+	explicit ConcurrentQueue(size_t capacity = 1024)
+		: capacity_(bit_ceil(capacity < 2 ? size_t(2) : capacity)),
+		  mask_(capacity_ - 1),
+		  cells_(make_unique<Cell[]>(capacity_)) {
+		for (size_t i = 0; i < capacity_; i++)
+			cells_[i].sequence.store(i, memory_order_relaxed);
+	}
+
+	ConcurrentQueue(const ConcurrentQueue&) = delete;
+	ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+	~ConcurrentQueue() {
+		while (try_pop_front())
+			;
+	}
+
+	size_t capacity() const { return capacity_; }
+
+	// Approximatif si d'autres fils modifient la file en même temps.
+	size_t size() const {
+		size_t tail = enqueuePos_.load(memory_order_acquire);
+		size_t head = dequeuePos_.load(memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+
+	bool empty() const { return size() == 0; }
+
+	// Retourne false si la file est pleine.
+	template <typename U>
+	bool try_push_back(U&& value) {
+		Cell* cell;
+		size_t pos = enqueuePos_.load(memory_order_relaxed);
+		while (true) {
+			cell = &cells_[pos & mask_];
+			size_t seq = cell->sequence.load(memory_order_acquire);
+			intptr_t diff = intptr_t(seq) - intptr_t(pos);
+			if (diff == 0) {
+				// La case est libre, on essaie de la réserver.
+				if (enqueuePos_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				// La case n'a pas encore été vidée depuis le tour précédent : la file est pleine.
+				return false;
+			} else {
+				pos = enqueuePos_.load(memory_order_relaxed);
+			}
+		}
+		try {
+			new (cell->storage) T(forward<U>(value));
+		} catch (...) {
+			cell->isTombstone = true;
+			cell->sequence.store(pos + 1, memory_order_release);
+			throw;
+		}
+		cell->sequence.store(pos + 1, memory_order_release);
+		return true;
+	}
+
+	// Attend (en cédant le processeur) qu'une case se libère si la file est pleine.
+	template <typename U>
+	void push_back(U&& value) {
+		while (not try_push_back(forward<U>(value)))
+			this_thread::yield();
+	}
+
+	// Retourne nullopt si la file est vide (sans exception, pour les boucles de consommation).
+	optional<T> try_pop_front() {
+		Cell* cell;
+		size_t pos = dequeuePos_.load(memory_order_relaxed);
+		while (true) {
+			cell = &cells_[pos & mask_];
+			size_t seq = cell->sequence.load(memory_order_acquire);
+			intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+			if (diff == 0) {
+				if (dequeuePos_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+					if (not cell->isTombstone)
+						break;
+					// Case sans valeur : on la libère et on passe à la suivante.
+					cell->isTombstone = false;
+					cell->sequence.store(pos + capacity_, memory_order_release);
+					pos = dequeuePos_.load(memory_order_relaxed);
+				}
+			} else if (diff < 0) {
+				return nullopt;
+			} else {
+				pos = dequeuePos_.load(memory_order_relaxed);
+			}
+		}
+		T* valuePtr = launder(reinterpret_cast<T*>(cell->storage));
+		optional<T> result(move(*valuePtr));
+		valuePtr->~T();
+		// La case sera prête pour l'écriture au prochain tour du tampon.
+		cell->sequence.store(pos + capacity_, memory_order_release);
+		return result;
+	}
+
+	T pop_front() {
+		optional<T> value = try_pop_front();
+		if (not value)
+			throw EmptyListError(EmptyListError::popMessage);
+		return move(*value);
+	}
+
+private:
+	// Taille d'une ligne de cache sur x86-64 et la plupart des ARM. On sépare les compteurs pour que producteurs et consommateurs ne se volent pas la même ligne.
+	static constexpr size_t cacheLineSize = 64;
+
+	struct Cell {
+		atomic<size_t>               sequence;
+		// Écrit avant la publication de la séquence et lu après, donc protégé par celle-ci.
+		bool                         isTombstone = false;
+		alignas(T) unsigned char     storage[sizeof(T)];
+	};
+
+	const size_t                        capacity_;
+	const size_t                        mask_;
+	unique_ptr<Cell[]>                  cells_;
+	alignas(cacheLineSize) atomic<size_t> enqueuePos_ = 0;
+	alignas(cacheLineSize) atomic<size_t> dequeuePos_ = 0;
+};
+
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+
+#pragma region "Includes" //{
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+#pragma endregion //}
+
+
+// L'instrumentation est optionnelle : il faut définir UTILS_LATENCY_INSTRUMENTATION (dans les options du projet ou avant d'inclure ce fichier) pour l'activer.
+// Sinon, la macro UTILS_MEASURE_LATENCY ne génère aucun code et ne coûte donc rien.
+#define UTILS_LATENCY_CONCAT_IMPL(a, b) a##b
+#define UTILS_LATENCY_CONCAT(a, b) UTILS_LATENCY_CONCAT_IMPL(a, b)
+
+#ifdef UTILS_LATENCY_INSTRUMENTATION
+// Mesure la durée de la portée courante et l'enregistre dans l'histogramme nommé 'operationName'.
+// L'histogramme est recherché une seule fois par site d'appel (variable locale statique), ensuite chaque appel ne coûte que deux lectures d'horloge et quelques incréments atomiques.
+#define UTILS_MEASURE_LATENCY(operationName) \
+	static ::utils::LatencyHistogram& UTILS_LATENCY_CONCAT(latencyHistogram_, __LINE__) = ::utils::LatencyRegistry::instance().histogram(operationName); \
+	::utils::ScopedLatencyTimer UTILS_LATENCY_CONCAT(latencyTimer_, __LINE__)(UTILS_LATENCY_CONCAT(latencyHistogram_, __LINE__))
+#else
+#define UTILS_MEASURE_LATENCY(operationName) ((void)0)
+#endif
+
+
+namespace utils {
+
+// Histogramme de latences inspiré de HdrHistogram : les intervalles sont linéaires jusqu'à 2^subBucketBits ns, puis chaque puissance de 2 est découpée en 2^subBucketBits sous-intervalles.
+// On garde ainsi une erreur relative bornée (~3%) sur toute la plage de valeurs avec un nombre fixe de compteurs, ce qui permet de voir les queues de distribution (p99, p999) que la moyenne cache.
+// Les compteurs sont atomiques (relaxed) pour qu'on puisse enregistrer depuis plusieurs fils d'exécution sans verrou.
+class LatencyHistogram
+{
+public:
+	static constexpr int      subBucketBits = 5;
+	static constexpr uint64_t subBucketCount = uint64_t(1) << subBucketBits;
+	static constexpr size_t   bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+	struct Percentiles {
+		uint64_t count = 0;
+		uint64_t p50 = 0;
+		uint64_t p99 = 0;
+		uint64_t p999 = 0;
+		uint64_t max = 0;
+	};
+
+	void record(uint64_t nanoseconds) {
+		counts_[bucketIndex(nanoseconds)].fetch_add(1, memory_order_relaxed);
+		totalCount_.fetch_add(1, memory_order_relaxed);
+		uint64_t previousMax = max_.load(memory_order_relaxed);
+		while (nanoseconds > previousMax and not max_.compare_exchange_weak(previousMax, nanoseconds, memory_order_relaxed))
+			;
+	}
+
+	void record(chrono::nanoseconds duration) {
+		record(uint64_t(duration.count() < 0 ? 0 : duration.count()));
+	}
+
+	uint64_t count() const { return totalCount_.load(memory_order_relaxed); }
+	uint64_t max() const { return max_.load(memory_order_relaxed); }
+
+	// Retourne la plus petite valeur (en ns) telle qu'au moins 'percent'% des mesures lui sont inférieures ou égales.
+	// Comme dans HdrHistogram, on retourne la borne supérieure de l'intervalle trouvé (bornée par le maximum observé).
+	uint64_t percentile(double percent) const {
+		uint64_t total = count();
+		if (total == 0)
+			return 0;
+		uint64_t target = uint64_t(percent / 100.0 * double(total) + 0.5);
+		target = clamp<uint64_t>(target, 1, total);
+
+		uint64_t seen = 0;
+		for (size_t i = 0; i < bucketCount; i++) {
+			seen += counts_[i].load(memory_order_relaxed);
+			if (seen >= target)
+				return min(bucketUpperBound(i), max());
+		}
+		return max();
+	}
+
+	Percentiles percentiles() const {
+		return {count(), percentile(50.0), percentile(99.0), percentile(99.9), max()};
+	}
+
+	void reset() {
+		for (auto& c : counts_)
+			c.store(0, memory_order_relaxed);
+		totalCount_.store(0, memory_order_relaxed);
+		max_.store(0, memory_order_relaxed);
+	}
+
+	static size_t bucketIndex(uint64_t value) {
+		if (value < subBucketCount)
+			return size_t(value);
+		// 'exponent' >= 1 et 'mantissa' est dans [subBucketCount, 2*subBucketCount[.
+		int exponent = bit_width(value) - subBucketBits;
+		uint64_t mantissa = value >> (exponent - 1);
+		return size_t(exponent * subBucketCount + (mantissa - subBucketCount));
+	}
+
+	static uint64_t bucketUpperBound(size_t index) {
+		if (index < subBucketCount)
+			return index;
+		int exponent = int(index / subBucketCount);
+		uint64_t mantissa = index % subBucketCount + subBucketCount;
+		uint64_t nextLow = (mantissa + 1) << (exponent - 1);
+		// Le dernier intervalle se termine à la valeur maximale représentable.
+		return nextLow == 0 ? UINT64_MAX : nextLow - 1;
+	}
+
+private:
+	array<atomic<uint64_t>, bucketCount> counts_{};
+	atomic<uint64_t>                     totalCount_ = 0;
+	atomic<uint64_t>                     max_ = 0;
+};
+
+
+// Objet RAII qui mesure le temps entre sa construction et sa destruction avec steady_clock.
+class ScopedLatencyTimer
+{
+public:
+	explicit ScopedLatencyTimer(LatencyHistogram& histogram)
+		: histogram_(histogram),
+		  start_(chrono::steady_clock::now()) { }
+
+	ScopedLatencyTimer(const ScopedLatencyTimer&) = delete;
+	ScopedLatencyTimer& operator=(const ScopedLatencyTimer&) = delete;
+
+	~ScopedLatencyTimer() {
+		histogram_.record(chrono::steady_clock::now() - start_);
+	}
+
+private:
+	LatencyHistogram&                 histogram_;
+	chrono::steady_clock::time_point  start_;
+};
+
+
+// Registre global des histogrammes, indexés par nom d'opération (ex. "Company::addEmployee").
+// Les histogrammes ne sont jamais détruits avant la fin du programme, donc les références retournées restent valides.
+class LatencyRegistry
+{
+public:
+	static LatencyRegistry& instance() {
+		static LatencyRegistry registry;
+		return registry;
+	}
+
+	LatencyHistogram& histogram(const string& operationName) {
+		lock_guard lock(mutex_);
+		unique_ptr<LatencyHistogram>& h = histograms_[operationName];
+		if (h == nullptr)
+			h = make_unique<LatencyHistogram>();
+		return *h;
+	}
+
+	map<string, LatencyHistogram::Percentiles> snapshot() const {
+		lock_guard lock(mutex_);
+		map<string, LatencyHistogram::Percentiles> result;
+		for (auto&& [name, h] : histograms_)
+			result[name] = h->percentiles();
+		return result;
+	}
+
+	void reset() {
+		lock_guard lock(mutex_);
+		for (auto&& [name, h] : histograms_)
+			h->reset();
+	}
+
+	// Affiche un tableau des percentiles (en microsecondes) de toutes les opérations mesurées.
+	void printReport(ostream& os) const {
+		auto toMicros = [] (uint64_t ns) { return double(ns) / 1000.0; };
+		auto previousFlags = os.flags();
+		auto previousPrecision = os.precision();
+		os << left << setw(40) << "Operation" << right
+		   << setw(12) << "count" << setw(12) << "p50 (us)" << setw(12) << "p99 (us)"
+		   << setw(12) << "p999 (us)" << setw(12) << "max (us)" << "\n";
+		os << fixed << setprecision(3);
+		for (auto&& [name, p] : snapshot()) {
+			os << left << setw(40) << name << right
+			   << setw(12) << p.count << setw(12) << toMicros(p.p50) << setw(12) << toMicros(p.p99)
+			   << setw(12) << toMicros(p.p999) << setw(12) << toMicros(p.max) << "\n";
+		}
+		os.flags(previousFlags);
+		os.precision(previousPrecision);
+	}
+
+private:
+	LatencyRegistry() = default;
+
+	mutable mutex                              mutex_;
+	map<string, unique_ptr<LatencyHistogram>>  histograms_;
+};
+
+}
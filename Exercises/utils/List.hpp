@@ -7,9 +7,16 @@
 #include <cstdint>
 #include <new>
 
+#include <bit>
 #include <ostream>
+#include <charconv>
+#include <locale>
+#include <string>
 #include <memory>
+#include <optional>
 #include <iomanip>
+#include <algorithm>
+#include <functional>
 #include <type_traits>
 #include <stdexcept>
 #include <initializer_list>
@@ -17,29 +24,71 @@
 #include <cppitertools/itertools.hpp>
 #include <cppitertools/zip.hpp>
 
+#include "LatencyHistogram.hpp"
+
 using namespace std;
 using namespace iter;
 
 #pragma endregion //}
 
 
+// MSVC accepte [[no_unique_address]] sans lui donner d'effet (pour garder son ABI) : il a son propre attribut.
+#ifdef _MSC_VER
+#define UTILS_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define UTILS_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+
 namespace utils {
 
 // Déclarations avancées. C'est un peu comme les prototypes de fonctions, mais pour les classes.
-template <typename> class ListNode_impl;
+// 'IsPooled' indique si le noeud peut venir du réservoir intégré d'une liste (donc seulement pour les listes avec InlineCapacity > 0).
+template <typename T, bool IsPooled = false> class ListNode_impl;
+template <typename> class ListNodePool_impl;
 template <typename, typename> class ListIterator_impl;
-template <typename> class List;
+// 'InlineCapacity' est le nombre de noeuds gardés directement dans l'objet List (0 par défaut, voir ListNodePool_impl).
+template <typename T, size_t InlineCapacity = 0> class List;
+
+
+// Un noeud peut être alloué sur le tas ou dans le réservoir de noeuds intégré à une liste (voir ListNodePool_impl). Le "deleter" du unique_ptr choisit la bonne façon de le détruire.
+template <typename T, bool IsPooled>
+struct ListNodeDeleter_impl {
+	void operator()(ListNode_impl<T, IsPooled>* node) const;
+};
+
+template <typename T, bool IsPooled = false>
+using ListNodePtr_impl = unique_ptr<ListNode_impl<T, IsPooled>, ListNodeDeleter_impl<T, IsPooled>>;
+
+
+// Le réservoir d'où vient un noeud (nul s'il a été alloué sur le tas). Seuls les noeuds qui peuvent venir d'un réservoir ont ce pointeur :
+// pour les autres, la classe de base est vide (elle ne prend aucune place dans le noeud) et 'pool_' est une constante nulle, donc le même code compile dans les deux cas.
+template <typename T, bool IsPooled>
+class ListNodePoolLink_impl
+{
+protected:
+	ListNodePool_impl<T>* pool_ = nullptr;
+};
+
+template <typename T>
+class ListNodePoolLink_impl<T, false>
+{
+protected:
+	static constexpr ListNodePool_impl<T>* pool_ = nullptr;
+};
 
 
 // Un noeud est un élément de la liste qui contient une valeur (générique dans ce cas) et connait le noeud qui le précède et qui le suit.
 // La classe de noeud est normalement transparente dans l'implémentation d'une liste, c-à-d qu'on ne s'en sert jamais directement, car c'est une classe utilisée à l'interne de la liste.
 // Ici, un noeud possède le noeud qui le suit, et la liste possède son premier noeud. De cette façon, lorsque le noeud est détruit, il détruit son prochain.
-template <typename T>
-class ListNode_impl
+template <typename T, bool IsPooled>
+class ListNode_impl : public ListNodePoolLink_impl<T, IsPooled>
 {
 	// On met la classe List du même type comme friend pour qu'elle puisse accéder aux membres privés
-	template <typename>
+	template <typename, size_t>
 	friend class List;
+	friend class ListNodePool_impl<T>;
+	friend struct ListNodeDeleter_impl<T, IsPooled>;
 
 public:
 	// Un truc très courant dans la librairie standard, on fait un typedef public 'value_type' qui représente le type des valeurs qu'on contient (donc 'T' dans le cas actuel)
@@ -47,26 +96,111 @@ public:
 
 	ListNode_impl() = default;
 
-	ListNode_impl(const T& value, ListNode_impl<T>* previous = {}, unique_ptr<ListNode_impl<T>>&& next = {})
-		: value_(make_unique<T>(value)),
+	// La valeur est directement dans le noeud (plutôt que dans un unique_ptr<T>), donc un seul bloc de mémoire par élément.
+	ListNode_impl(const T& value, ListNode_impl* previous = {}, ListNodePtr_impl<T, IsPooled>&& next = {})
+		: value_(value),
 		  previous_(previous),
 		  next_(move(next)) { }
 
+	explicit ListNode_impl(T&& value)
+		: value_(move(value)) { }
+
 	// On n'a rien à faire dans le destructor, car lorsqu'on détruit le membre 'next_', son destructeur se fait appeler, détruisant son prochain, et ainsi de suite jusqu'au dernier élément de la liste (dont le suivant est nul).
 	// Toutefois, les appels sont récursifs et causent un débordement de pile pour un nombre modéré d'éléments (dans le millier). On peut régler le problème avec une boucle qui détruit les noeuds suivants sans appels récursifs (pas important pour le cours).
 	~ListNode_impl() = default;
 
-	T& getValue() { return *value_; }
-	const T& getValue() const { return *value_; }
-	ListNode_impl<T>* getPrevious() const { return previous_; }
-	ListNode_impl<T>* getNext() const { return next_.get(); }
+	T& getValue() { return value_; }
+	const T& getValue() const { return value_; }
+	ListNode_impl* getPrevious() const { return previous_; }
+	ListNode_impl* getNext() const { return next_.get(); }
+
+private:
+	T                            value_{};
+	ListNode_impl*                   previous_ = nullptr;
+	ListNodePtr_impl<T, IsPooled>    next_;
+};
+
+
+// Réservoir de noeuds intégré à une liste (au plus 64 places), pour que les petites listes ne fassent aucune allocation.
+// Un masque de bits indique les places occupées. Le réservoir ne possède pas les noeuds : c'est la chaîne de unique_ptr de la liste qui les possède, et le deleter rend la place au réservoir.
+template <typename T>
+class ListNodePool_impl
+{
+public:
+	using NodeType = ListNode_impl<T, true>;
+
+	ListNodePool_impl(const ListNodePool_impl&) = delete;
+	ListNodePool_impl& operator=(const ListNodePool_impl&) = delete;
+
+	size_t capacity() const { return capacity_; }
+	bool hasNodesInUse() const { return used_ != 0; }
+	// Le masque des places occupées, et le bit de la place d'un noeud du réservoir.
+	uint64_t slotsInUse() const { return used_; }
+	uint64_t slotBit(const NodeType* node) const { return uint64_t(1) << ((reinterpret_cast<const unsigned char*>(node) - slots_) / sizeof(NodeType)); }
+
+	// Construit un noeud dans une place libre, ou retourne nul si le réservoir est plein.
+	template <typename... Args>
+	NodeType* tryCreate(Args&&... args) {
+		if (capacity_ == 0 or popcount(used_) == int(capacity_))
+			return nullptr;
+		int index = countr_one(used_);
+		NodeType* node = new (slots_ + index * sizeof(NodeType)) NodeType(forward<Args>(args)...);
+		node->pool_ = this;
+		used_ |= uint64_t(1) << index;
+		return node;
+	}
+
+	void destroy(NodeType* node) {
+		size_t index = (reinterpret_cast<unsigned char*>(node) - slots_) / sizeof(NodeType);
+		node->~NodeType();
+		used_ &= ~(uint64_t(1) << index);
+	}
+
+	// Appelle 'fn' sur chaque noeud présentement construit dans le réservoir.
+	template <typename Fn>
+	void forEachNodeInUse(Fn&& fn) {
+		for (uint64_t remaining = used_; remaining != 0; remaining &= remaining - 1)
+			fn(launder(reinterpret_cast<NodeType*>(slots_ + countr_zero(remaining) * sizeof(NodeType))));
+	}
+
+protected:
+	ListNodePool_impl(unsigned char* slots, size_t capacity) : slots_(slots), capacity_(capacity) { }
+	~ListNodePool_impl() = default;
+
+private:
+	unsigned char* slots_;
+	size_t         capacity_;
+	uint64_t       used_ = 0;
+};
+
+template <typename T, size_t N>
+class ListInlineStorage_impl : public ListNodePool_impl<T>
+{
+	static_assert(N <= 64, "A List can hold at most 64 inline nodes.");
+
+public:
+	ListInlineStorage_impl() : ListNodePool_impl<T>(storage_, N) { }
 
 private:
-	unique_ptr<T>                value_;
-	ListNode_impl<T>*            previous_ = nullptr;
-	unique_ptr<ListNode_impl<T>> next_;
+	alignas(ListNode_impl<T, true>) unsigned char storage_[N * sizeof(ListNode_impl<T, true>)];
 };
 
+// Sans capacité intégrée, il n'y a rien à stocker.
+template <typename T>
+class ListInlineStorage_impl<T, 0> { };
+
+
+template <typename T, bool IsPooled>
+void ListNodeDeleter_impl<T, IsPooled>::operator()(ListNode_impl<T, IsPooled>* node) const {
+	if constexpr (IsPooled) {
+		if (node->pool_ != nullptr) {
+			node->pool_->destroy(node);
+			return;
+		}
+	}
+	delete node;
+}
+
 
 // Un itérateur est une objet qui pointe vers un élément d'un conteneur et dont l'interface ressemble à celle d'un pointeur (++ et -- pour avancer/reculer, * pour accéder à la valeur).
 // Pour permettre des itérateurs qui pointent vers des listes constantes ou modifiable, on passe le type de liste et de noeud en paramètre
@@ -74,7 +208,7 @@ template <class ListT, class NodeT>
 class ListIterator_impl
 {
 	// On met List comme ami.
-	template <typename>
+	template <typename, size_t>
 	friend class List;
 
 public:
@@ -94,6 +228,7 @@ public:
 	ListIterator_impl& operator=(const ListIterator_impl&) = default;
 
 	// Interface ressemblant à un pointeur. * pour accéder à la valeur, ++ et -- pour avancer/reculer, puis == et != pour comparer.
+	// Lire par * ne touche pas à la liste (plusieurs fils peuvent la parcourir en même temps). Avec l'empreinte en cache, une valeur se modifie par List::modify(), qui le sait, et non par la référence retournée.
 	value_type& operator*() { return elem_->getValue(); }
 	const value_type& operator*() const { return elem_->getValue(); }
 
@@ -135,6 +270,8 @@ struct ForeignIteratorError : public ListError {
 
 struct EmptyListError : public ListError {
 	using ListError::ListError;
+	// Le message des pop sur un conteneur vide, aussi affiché tel quel par les versions sans exception (voir try_pop_front()).
+	static constexpr const char* popMessage = "Cannot pop from an empty list.";
 	void raise() const override {
 		throw *this;
 	}
@@ -142,8 +279,67 @@ struct EmptyListError : public ListError {
 
 
 
+// Affiche les éléments de [first, last[ séparés par des espaces, chacun avec la largeur 'width' (ce que font les operator<< de List et RingDeque entre les crochets).
+// Pour des entiers, si le flux est dans un état où le résultat serait le même (base 10, sans showpos/showbase, pas d'alignement "internal", locale "C"), on formate tout avec to_chars dans un tampon réutilisé qu'on écrit par gros blocs.
+// Ça évite une insertion formatée (sentinelle, setw, locale) par élément, ce qui compte quand on affiche de grosses listes à répétition.
+template <typename It>
+void printElements_impl(ostream& os, It first, It last, streamsize width) {
+	using ValueType = remove_cvref_t<decltype(*first)>;
+	// bool et les types caractères s'affichent autrement que des nombres.
+	constexpr bool isPlainInteger = is_integral_v<ValueType> and sizeof(ValueType) >= sizeof(short)
+	                                and not is_same_v<ValueType, wchar_t> and not is_same_v<ValueType, char16_t> and not is_same_v<ValueType, char32_t>;
+
+	if constexpr (isPlainInteger) {
+		auto flags = os.flags();
+		auto base = flags & ios::basefield;
+		bool isDefaultFormat = (base == ios::dec or base == 0) and not (flags & (ios::showpos | ios::showbase))
+		                       and (flags & ios::adjustfield) != ios::internal and os.getloc() == locale::classic();
+		if (isDefaultFormat) {
+			static constexpr size_t flushSize = 1 << 16;
+			thread_local string buffer;
+			buffer.clear();
+			bool isLeftAligned = (flags & ios::adjustfield) == ios::left;
+			char fill = os.fill();
+
+			auto flush = [&] {
+				if (os.rdbuf()->sputn(buffer.data(), buffer.size()) != streamsize(buffer.size()))
+					os.setstate(ios::badbit);
+				buffer.clear();
+			};
+
+			for (It it = first; it != last and os.good(); ++it) {
+				if (it != first)
+					buffer += ' ';
+				char digits[24];
+				auto [end, error] = to_chars(digits, digits + sizeof(digits), *it);
+				size_t length = size_t(end - digits);
+				size_t padding = width > streamsize(length) ? size_t(width) - length : 0;
+				if (not isLeftAligned)
+					buffer.append(padding, fill);
+				buffer.append(digits, length);
+				if (isLeftAligned)
+					buffer.append(padding, fill);
+				if (buffer.size() >= flushSize)
+					flush();
+			}
+			if (os.good())
+				flush();
+			return;
+		}
+	}
+
+	for (It it = first; it != last; ++it) {
+		if (it != first)
+			os << " ";
+		os << setw(width) << *it;
+	}
+}
+
+
 // Une liste bidirectionnelle est une séquence de noeuds qui connaissent leur noeuds précédents et suivants.
-template <typename T>
+// Avec InlineCapacity > 0, les InlineCapacity premiers noeuds sont construits dans l'objet List lui-même (aucune allocation), et les suivants sur le tas.
+// Comme pour les "small vectors", déplacer une telle liste (ou en transférer des noeuds vers une autre liste) recrée ailleurs les noeuds intégrés, ce qui invalide les itérateurs qui pointent vers eux.
+template <typename T, size_t InlineCapacity>
 class List
 {
 	// On met Iterateur ami (pour accéder à 'last_').
@@ -153,12 +349,14 @@ class List
 public:
 	// Un autre paquet de typedef qui reflète ce qui est fait dans la librairie standard.
 	using value_type = T; // Le type des éléments
-	using iterator = typename ListIterator_impl<List<T>, ListNode_impl<T>>; // Le type d'itérateur pour une liste modifiable
-	using const_iterator = typename ListIterator_impl<const List<T>, const ListNode_impl<T>>; // Le type d'itérateur pour une liste non-modifiable.
+	using iterator = typename ListIterator_impl<List, ListNode_impl<T, (InlineCapacity > 0)>>; // Le type d'itérateur pour une liste modifiable
+	using const_iterator = typename ListIterator_impl<const List, const ListNode_impl<T, (InlineCapacity > 0)>>; // Le type d'itérateur pour une liste non-modifiable.
 
 	List() = default;
 
 	List(const List& other) {
+		// La copie garde le mode de hachage de l'original.
+		hashCaching_ = other.hashCaching_;
 		// On réutilise notre opérateur d'affectation
 		*this = other;
 	}
@@ -175,14 +373,23 @@ public:
 		*this = elements;
 	}
 
+	// Le destructeur par défaut détruirait les noeuds récursivement (voir ~ListNode_impl); on les détruit plutôt un à un avec une boucle.
+	~List() {
+		clear();
+	}
+
 	List& operator=(const List& other) {
 		if (&other == this)
 			return *this;
 
-		resize(other.size());
-		// Cette syntaxe (le "range-based for", ou "foreach") est rendue possible par les itérateurs qui ont *, ++ et !=, ainsi que la liste qui a begin() et end().
-		for (auto&& [e1, e2] : zip(*this, other))
-			e1 = e2;
+		// Une seule passe sur 'other' (voir assignRange()), qu'on soit en train de construire une copie ou d'affecter dans une liste non vide.
+		assignRange(other.begin(), other.end());
+		// Mêmes valeurs, donc même empreinte : on la récupère si l'autre liste l'avait déjà calculée.
+		if (hashCaching_ and other.hashCaching_ and other.hashValid_) {
+			hash_ = other.hash_;
+			basePower_ = other.basePower_;
+			hashValid_ = true;
+		}
 		return *this;
 	}
 
@@ -190,24 +397,31 @@ public:
 		if (&other == this)
 			return *this;
 
+		clear();
+		// Les noeuds intégrés à 'other' ne peuvent pas changer de propriétaire : on les recrée dans notre propre réservoir (qui est vide après clear()).
+		other.relocatePoolNodes(pool());
 		first_ = move(other.first_);
 		last_ = other.last_;
 		size_ = other.size_;
+		hashCaching_ = other.hashCaching_;
+		hashValid_ = other.hashValid_;
+		hash_ = other.hash_;
+		basePower_ = other.basePower_;
 		other.last_ = nullptr;
 		other.size_ = 0;
+		other.invalidateHash();
 
 		return *this;
 	}
 
 	List& operator=(initializer_list<value_type> elements) {
-		resize(elements.size());
-		// Même concept qu'avec l'opérateur par copie : on redimensionne puis on copie.
-		for (auto&& [e1, e2] : zip(*this, elements))
-			e1 = e2;
+		// Même concept qu'avec l'opérateur par copie.
+		assignRange(elements.begin(), elements.end());
 		return *this;
 	}
 
 	// Interface de création d'itérateurs compatible avec la librairie standard et les range-based-for.
+	// Ce n'est pas la création d'un itérateur non constant qui invalide l'empreinte en cache, mais chaque accès à une valeur par celui-ci (voir ListIterator_impl::operator*).
 	iterator begin() { return iterator(first_.get(), this); }
 	iterator end() { return iterator(nullptr, this); }
 	const_iterator begin() const { return const_iterator(first_.get(), this); }
@@ -216,6 +430,18 @@ public:
 	size_t size() const { return size_; }
 	bool empty() const { return size_ == 0; }
 
+	void clear() {
+		// En remplaçant le premier par son suivant, l'ancien premier est détruit alors que son 'next_' est déjà vide, donc sans récursion.
+		while (first_ != nullptr)
+			first_ = move(first_->next_);
+		last_ = nullptr;
+		size_ = 0;
+		// L'empreinte d'une liste vide est connue.
+		hash_ = 0;
+		basePower_ = 1;
+		hashValid_ = hashCaching_;
+	}
+
 	void resize(size_t size) {
 		while (size_ < size)
 			push_back(T{});
@@ -225,6 +451,7 @@ public:
 
 	// L'insertion (comme pour le insert() des conteneurs standards) se fait à l'endroit spécifié. L'élément pointé par l'argument 'position' se retrouvera donc après l'élément inséré.
 	iterator insert (iterator position, const T& value) {
+		UTILS_MEASURE_LATENCY("List::insert");
 		// On vérifie que l'itérateur nous appartient...
 		if (position.parent_ != this)
 			throw ForeignIteratorError("Nah girl, I ain't yo daddy!");
@@ -239,7 +466,7 @@ public:
 		} else {
 			NodeType* after = position.elem_;
 			NodeType* before = after->previous_;
-			unique_ptr<NodeType> newNode = make_unique<NodeType>(value);
+			NodePtr newNode = makeNode(value);
 			NodeType* newNodePtr = newNode.get();
 
 			// Étant donné qu'un noeud possède son suivant, il faut faire attention à l'ordre des opérations.
@@ -249,23 +476,30 @@ public:
 			before->next_ = move(newNode);
 
 			size_++;
+			invalidateHash();
 			return iterator(newNodePtr, this);
 		}
 	}
 
 	void push_front(const T& valeur) {
-		auto newNode = make_unique<NodeType>(valeur);
-		first_->previous_ = newNode.get();
+		auto newNode = makeNode(valeur);
+		if (first_ != nullptr)
+			first_->previous_ = newNode.get();
 		newNode->next_ = move(first_);
 		first_ = move(newNode);
 		if (size_ == 0)
 			last_ = first_.get();
 
 		size_++;
+		if (hashValid_) {
+			// La nouvelle valeur prend le poids B^n.
+			hash_ += elementHash(valeur) * basePower_;
+			basePower_ *= hashBase;
+		}
 	}
 
 	void push_back(const T& valeur) {
-		auto newNode = make_unique<NodeType>(valeur);
+		auto newNode = makeNode(valeur);
 		auto* newNodePtr = newNode.get();
 		if (size_ == 0) {
 			first_ = move(newNode);
@@ -276,10 +510,24 @@ public:
 
 		last_ = newNodePtr;
 		size_++;
+		if (hashValid_) {
+			// Toutes les valeurs prennent un facteur B de plus et la nouvelle a le poids 1.
+			hash_ = hash_ * hashBase + elementHash(valeur);
+			basePower_ *= hashBase;
+		}
+	}
+
+	// Remplace la valeur pointée par 'position'. C'est la façon de modifier une valeur quand l'empreinte est en cache (voir contentHash()) : une écriture par *it ne serait pas vue.
+	void modify(iterator position, T value) {
+		if (position.parent_ != this)
+			throw ForeignIteratorError("Nah girl, I ain't yo daddy!");
+		position.elem_->getValue() = move(value);
+		invalidateHash();
 	}
 
 	// Pour faire comme les erase() des différents conteneurs de la stdlib, erase() retourne un itérateur
 	iterator erase (iterator position) {
+		UTILS_MEASURE_LATENCY("List::erase");
 		// On vérifie que l'itérateur nous appartient...
 		if (position.parent_ != this)
 			throw ForeignIteratorError("You are... NOT THE FATHER!");
@@ -299,77 +547,558 @@ public:
 			after->previous_ = before;
 			before->next_ = move(erasePos->next_);
 
+			size_--;
+			invalidateHash();
 			return iterator(after, this);
 		}
 	}
 
+	// Enlève les éléments de [first, last[ d'un seul coup (une seule opération de reliage) et retourne 'last'.
+	iterator erase(iterator first, iterator last) {
+		if (first.parent_ != this or last.parent_ != this)
+			throw ForeignIteratorError("You are... NOT THE FATHER!");
+		if (first == last)
+			return last;
+
+		invalidateHash();
+		NodePtr removed = unlinkRange(first.elem_, last.elem_);
+		// On détruit la chaîne détachée avec une boucle (comme clear()) en comptant les noeuds.
+		while (removed != nullptr) {
+			removed = move(removed->next_);
+			size_--;
+		}
+		return last;
+	}
+
+	// Déplace tous les éléments de 'other' avant 'position', en O(1). 'other' se retrouve vide.
+	void splice(iterator position, List& other) {
+		if (position.parent_ != this)
+			throw ForeignIteratorError("Nah girl, I ain't yo daddy!");
+		if (&other == this or other.empty())
+			return;
+
+		other.relocatePoolNodes(pool());
+		linkRange(position.elem_, move(other.first_), other.last_);
+		size_ += other.size_;
+		other.last_ = nullptr;
+		other.size_ = 0;
+		invalidateHash();
+		other.invalidateHash();
+	}
+
+	void splice(iterator position, List&& other) {
+		splice(position, other);
+	}
+
+	// Déplace l'élément pointé par 'element' (qui appartient à 'other', possiblement *this) avant 'position', en O(1).
+	void splice(iterator position, List& other, iterator element) {
+		if (position.parent_ != this or element.parent_ != &other)
+			throw ForeignIteratorError("Nah girl, I ain't yo daddy!");
+		NodeType* node = element.elem_;
+		// Rien à faire si l'élément est déjà à cette position.
+		if (node == nullptr or (&other == this and (node == position.elem_ or node->next_.get() == position.elem_)))
+			return;
+
+		if (&other != this and node->pool_ != nullptr)
+			node = other.relocateNode(node, pool());
+		NodePtr chain = other.unlinkRange(node, node->next_.get());
+		linkRange(position.elem_, move(chain), node);
+		other.size_--;
+		size_++;
+		invalidateHash();
+		other.invalidateHash();
+	}
+
+	// Déplace les éléments de [first, last[ de 'other' avant 'position'. Le reliage est en O(1), mais entre deux listes différentes il faut parcourir l'intervalle pour mettre les tailles à jour (comme std::list).
+	// 'position' ne doit pas être dans [first, last[.
+	void splice(iterator position, List& other, iterator first, iterator last) {
+		if (position.parent_ != this or first.parent_ != &other or last.parent_ != &other)
+			throw ForeignIteratorError("Nah girl, I ain't yo daddy!");
+		if (first == last or (&other == this and (position == first or position == last)))
+			return;
+
+		size_t count = 0;
+		NodeType* rangeFirst = first.elem_;
+		if (&other != this) {
+			// Les noeuds intégrés au réservoir de 'other' sont recréés dans le nôtre s'il reste de la place, sinon sur le tas, pendant qu'on compte (les autres restent où ils sont).
+			// Chaque noeud n'est visité qu'une fois : un noeud recréé dans notre réservoir a lui aussi un 'pool_'.
+			for (NodeType* node = rangeFirst; node != last.elem_; node = node->next_.get()) {
+				if (node->pool_ != nullptr) {
+					bool isFirst = node == rangeFirst;
+					node = other.relocateNode(node, pool());
+					if (isFirst)
+						rangeFirst = node;
+				}
+				count++;
+			}
+		}
+
+		NodeType* rangeLast = last.elem_ != nullptr ? last.elem_->previous_ : other.last_;
+		NodePtr chain = other.unlinkRange(rangeFirst, last.elem_);
+		linkRange(position.elem_, move(chain), rangeLast);
+		other.size_ -= count;
+		size_ += count;
+		invalidateHash();
+		other.invalidateHash();
+	}
+
+	// Coupe la liste avant 'position' : les éléments de [position, end[ sont déplacés (sans copie) dans la liste retournée.
+	// Pour la taille, on compte en même temps vers l'avant et vers l'arrière à partir de 'position', donc le coût est proportionnel à la plus petite des deux parties.
+	List split_at(iterator position) {
+		if (position.parent_ != this)
+			throw ForeignIteratorError("Nah girl, I ain't yo daddy!");
+		List tail;
+		if (position.elem_ == nullptr)
+			return tail;
+
+		// On note aussi les places de notre réservoir rencontrées de chaque côté.
+		size_t tailSize = 0;
+		size_t headSize = 0;
+		uint64_t tailSlots = 0;
+		uint64_t headSlots = 0;
+		NodeType* forward = position.elem_;
+		NodeType* backward = position.elem_->previous_;
+		while (forward != nullptr and backward != nullptr) {
+			tailSlots |= poolSlotBit(forward);
+			headSlots |= poolSlotBit(backward);
+			forward = forward->next_.get();
+			backward = backward->previous_;
+			tailSize++;
+			headSize++;
+		}
+		// Si on a atteint le début avant la fin, c'est la partie de tête qu'on a comptée au complet.
+		if (forward != nullptr)
+			tailSize = size_ - headSize;
+
+		// Les noeuds de notre réservoir qui passent dans la queue ne peuvent pas y rester : on les recrée dans le réservoir de la queue (vide, donc assez grand). Ceux de la tête ne bougent pas.
+		// La partie comptée au complet dit lesquels sont dans la queue.
+		if constexpr (InlineCapacity > 0) {
+			if (forward != nullptr)
+				tailSlots = inlineNodes_.slotsInUse() & ~headSlots;
+			inlineNodes_.forEachNodeInUse([&] (NodeType* node) {
+				if (tailSlots & inlineNodes_.slotBit(node)) {
+					bool isPosition = node == position.elem_;
+					NodeType* replacement = relocateNode(node, tail.pool());
+					if (isPosition)
+						position.elem_ = replacement;
+				}
+			});
+		}
+
+		NodeType* tailLast = last_;
+		tail.first_ = unlinkRange(position.elem_, nullptr);
+		tail.last_ = tailLast;
+		tail.size_ = tailSize;
+		size_ -= tailSize;
+		tail.hashCaching_ = hashCaching_;
+		invalidateHash();
+		return tail;
+	}
+
 	void pop_front() {
 		if (empty())
-			throw EmptyListError("Cannot pop from an empty list.");
-		if (first_->next_ != nullptr)
-			first_->next_->previous_ = nullptr;
-		first_ = move(first_->next_);
-		size_--;
+			throw EmptyListError(EmptyListError::popMessage);
+		detachFront();
 	}
 
 	void pop_back() {
 		if (empty())
-			throw EmptyListError("Cannot pop from an empty list.");
-		if (last_->previous_ != nullptr) {
-			last_ = last_->previous_;
-			last_->next_.reset();
-			size_--;
-		} else {
-			// Si le dernier n'a pas de précédent, alors la liste a un seul élément et on réutilise pop_front() qui traite déjà ce cas.
-			pop_front();
+			throw EmptyListError(EmptyListError::popMessage);
+		detachBack();
+	}
+
+	// Comme pop_front()/pop_back(), mais sans exception : on retourne la valeur enlevée, ou nullopt si la liste est vide.
+	// Pour les boucles où une liste vide est un cas normal (comme parseFile), ça évite le coût de lancer et attraper une exception.
+	optional<T> try_pop_front() {
+		if (empty())
+			return nullopt;
+		return move(detachFront()->value_);
+	}
+
+	optional<T> try_pop_back() {
+		if (empty())
+			return nullopt;
+		return move(detachBack()->value_);
+	}
+
+	// Tri stable par fusion ascendante (bottom-up) qui ne fait que relier les noeuds existants : aucune copie de valeur et aucune allocation.
+	// C'est le même principe que le sort() de std::list : on garde des séquences triées de taille 2^i dans des "bacs" (sur la pile) et on fusionne comme une addition binaire avec retenue.
+	// Les itérateurs restent valides et pointent vers les mêmes valeurs (seul l'ordre change).
+	template <typename Compare = less<>>
+	void sort(Compare comp = {}) {
+		if (size_ < 2)
+			return;
+
+		// 64 bacs suffisent, puisque le bac i contient 2^i noeuds.
+		NodePtr bins[64];
+		int nBinsUsed = 0;
+		NodePtr carry;
+		NodePtr result;
+		invalidateHash();
+		try {
+			while (first_ != nullptr) {
+				// On détache le premier noeud de la liste pour en faire une séquence triée de longueur 1.
+				carry = move(first_);
+				first_ = move(carry->next_);
+
+				int i = 0;
+				// Les bacs contiennent des noeuds plus anciens que 'carry', donc on les met à gauche pour garder le tri stable.
+				for (; i < nBinsUsed and bins[i] != nullptr; i++) {
+					mergeChains(bins[i], carry, comp);
+					carry = move(bins[i]);
+				}
+				bins[i] = move(carry);
+				if (i == nBinsUsed)
+					nBinsUsed++;
+			}
+
+			for (int i = 0; i < nBinsUsed; i++) {
+				if (bins[i] != nullptr) {
+					mergeChains(bins[i], result, comp);
+					result = move(bins[i]);
+				}
+			}
+		} catch (...) {
+			// Si la comparaison lance une exception, on remet tous les noeuds dans la liste (dans un ordre quelconque) avant de la relancer, pour ne perdre aucun élément.
+			NodePtr* tail = &first_;
+			appendChain(tail, carry);
+			appendChain(tail, result);
+			for (int i = 0; i < nBinsUsed; i++)
+				appendChain(tail, bins[i]);
+			relinkPrevious();
+			throw;
+		}
+		first_ = move(result);
+		relinkPrevious();
+	}
+
+	// Fusionne une liste déjà triée dans celle-ci (aussi triée) en reliant les noeuds. 'other' se retrouve vide.
+	// À valeurs égales, les éléments de *this restent avant ceux de 'other'.
+	template <typename Compare = less<>>
+	void merge(List&& other, Compare comp = {}) {
+		if (&other == this or other.empty())
+			return;
+		other.relocatePoolNodes(pool());
+		size_ += other.size_;
+		other.last_ = nullptr;
+		other.size_ = 0;
+		invalidateHash();
+		other.invalidateHash();
+		try {
+			mergeChains(first_, other.first_, comp);
+		} catch (...) {
+			// Tous les noeuds sont quand même dans 'first_' (voir mergeChains()).
+			relinkPrevious();
+			throw;
+		}
+		relinkPrevious();
+	}
+
+	// Empreinte polynomiale du contenu : somme des h(e_i) * B^(n-1-i) modulo 2^64, où h mélange std::hash<T>.
+	// Par défaut, elle est recalculée à chaque appel (O(n)). Avec enableHashCaching(), elle est gardée en cache et mise à jour en O(1) par push_back/push_front/pop_front/pop_back.
+	// Les autres modifications (insert, erase, modify, splice, sort, etc.) invalident le cache, qui sera recalculé une seule fois au prochain appel.
+	// Une écriture directe par la référence d'un itérateur (*it = ...) ne peut pas être suivie : avec le cache, on passe par modify().
+	// Attention, le cache est modifié par cette méthode const : ne pas l'appeler en même temps depuis plusieurs fils sur la même liste.
+	size_t contentHash() const {
+		if (hashValid_)
+			return size_t(hash_);
+
+		uint64_t hash = 0;
+		uint64_t power = 1;
+		for (auto&& e : *this) {
+			hash = hash * hashBase + elementHash(e);
+			power *= hashBase;
+		}
+		if (hashCaching_) {
+			hash_ = hash;
+			basePower_ = power;
+			hashValid_ = true;
 		}
+		return size_t(hash);
 	}
 
-	bool operator==(const List<T>& rhs) const {
+	void enableHashCaching(bool enabled = true) {
+		static_assert(isHashable, "List::enableHashCaching() requires std::hash<T>.");
+		hashCaching_ = enabled;
+		invalidateHash();
+		if (enabled)
+			contentHash();
+	}
+
+	bool isHashCachingEnabled() const { return hashCaching_; }
+
+	bool operator==(const List& rhs) const {
 		if (size() != rhs.size())
 			return false;
+		// Deux empreintes en cache différentes suffisent à conclure sans parcourir les listes (des empreintes égales, elles, ne prouvent rien).
+		if (hashValid_ and rhs.hashValid_ and hash_ != rhs.hash_)
+			return false;
 		for (auto&& [e1, e2] : zip(*this, rhs))
 			if (e1 != e2)
 				return false;
 		return true;
 	}
 
-	bool operator<(const List<T>& rhs) const {
+	bool operator<(const List& rhs) const {
 		return lexicographical_compare(begin(), end(), rhs.begin(), rhs.end());
 	}
 
 	friend ostream& operator<<(ostream& lhs, const List& rhs) {
 		auto printWidth = lhs.width();
 		lhs << "[";
-		for (auto&& [i, e] : enumerate(rhs)) {
-			lhs << setw(printWidth) << e;
-			if (i != rhs.size() - 1)
-				lhs << " ";
-		}
+		printElements_impl(lhs, rhs.begin(), rhs.end(), printWidth);
 		lhs << "]";
 		return lhs;
 	}
 
 private:
-	using NodeType = ListNode_impl<T>;
+	using NodeType = ListNode_impl<T, (InlineCapacity > 0)>;
+	using NodePtr = ListNodePtr_impl<T, (InlineCapacity > 0)>;
+	using PoolType = ListNodePool_impl<T>;
 
-	unique_ptr<NodeType> first_;
+	PoolType* pool() {
+		if constexpr (InlineCapacity > 0)
+			return &inlineNodes_;
+		else
+			return nullptr;
+	}
+
+	// Détache le premier (ou le dernier) noeud d'une liste non vide et le retourne, pour que l'appelant puisse récupérer sa valeur avant qu'il soit détruit.
+	NodePtr detachFront() {
+		if (hashValid_) {
+			// La première valeur avait le poids B^(n-1).
+			basePower_ *= hashBaseInverse;
+			hash_ -= elementHash(first_->getValue()) * basePower_;
+		}
+		NodePtr node = move(first_);
+		first_ = move(node->next_);
+		if (first_ != nullptr)
+			first_->previous_ = nullptr;
+		else
+			// 'last_' ne doit pas pointer vers le noeud détruit (linkRange() et splice() s'en servent quand la liste est vide).
+			last_ = nullptr;
+		size_--;
+		return node;
+	}
+
+	NodePtr detachBack() {
+		// Si le dernier n'a pas de précédent, alors la liste a un seul élément et on réutilise detachFront() qui traite déjà ce cas.
+		if (last_->previous_ == nullptr)
+			return detachFront();
+		if (hashValid_) {
+			// La dernière valeur avait le poids 1, et on divise tout par B (B est impair, donc inversible modulo 2^64).
+			hash_ = (hash_ - elementHash(last_->getValue())) * hashBaseInverse;
+			basePower_ *= hashBaseInverse;
+		}
+		last_ = last_->previous_;
+		NodePtr node = move(last_->next_);
+		node->previous_ = nullptr;
+		size_--;
+		return node;
+	}
+
+	// Copie les valeurs de [first, last[ en une seule passe, sans construire de valeur par défaut :
+	// les noeuds existants reçoivent les premières valeurs par affectation (aucune allocation), les valeurs restantes sont construites par copie directement dans de nouveaux noeuds déjà reliés à la fin, et les noeuds en trop sont détachés d'un coup puis détruits.
+	// Les noeuds restent alloués un par un : chacun appartient à la chaîne de unique_ptr et peut être transféré seul à une autre liste (splice), ce qu'un bloc commun empêcherait.
+	template <typename InputIt>
+	void assignRange(InputIt first, InputIt last) {
+		invalidateHash();
+		NodeType* node = first_.get();
+		for (; node != nullptr and first != last; ++first) {
+			node->value_ = *first;
+			node = node->next_.get();
+		}
+
+		if (node != nullptr) {
+			NodePtr removed = unlinkRange(node, nullptr);
+			// Comme clear(), avec une boucle pour éviter la destruction récursive.
+			while (removed != nullptr) {
+				removed = move(removed->next_);
+				size_--;
+			}
+			return;
+		}
+		for (; first != last; ++first) {
+			NodePtr newNode = makeNode(*first, last_);
+			NodeType* newNodePtr = newNode.get();
+			(last_ != nullptr ? last_->next_ : first_) = move(newNode);
+			last_ = newNodePtr;
+			size_++;
+		}
+	}
+
+	// Crée un noeud dans le réservoir intégré s'il reste de la place, sinon sur le tas.
+	template <typename... Args>
+	NodePtr makeNode(Args&&... args) {
+		if constexpr (InlineCapacity > 0)
+			if (NodeType* node = inlineNodes_.tryCreate(forward<Args>(args)...))
+				return NodePtr(node);
+		return NodePtr(new NodeType(forward<Args>(args)...));
+	}
+
+	// Remplace 'node' dans notre chaîne par un nouveau noeud (dans 'target' s'il y a de la place, sinon sur le tas) qui reçoit sa valeur par déplacement, puis détruit l'ancien.
+	// Sert à sortir un noeud de notre réservoir avant de le donner à une autre liste. Retourne le nouveau noeud.
+	NodeType* relocateNode(NodeType* node, PoolType* target) {
+		NodeType* replacement = nullptr;
+		if constexpr (InlineCapacity > 0)
+			if (target != nullptr)
+				replacement = target->tryCreate(move(node->value_));
+		if (replacement == nullptr)
+			replacement = new NodeType(move(node->value_));
+		NodePtr& owner = node->previous_ != nullptr ? node->previous_->next_ : first_;
+
+		replacement->previous_ = node->previous_;
+		replacement->next_ = move(node->next_);
+		if (replacement->next_ != nullptr)
+			replacement->next_->previous_ = replacement;
+		else
+			last_ = replacement;
+		// L'ancien noeud (qui n'a plus de suivant) est détruit par cette affectation.
+		owner = NodePtr(replacement);
+		return replacement;
+	}
+
+	// Le bit de la place de 'node' dans notre réservoir, ou 0 s'il est sur le tas.
+	uint64_t poolSlotBit(const NodeType* node) const {
+		if constexpr (InlineCapacity > 0)
+			if (node->pool_ != nullptr)
+				return inlineNodes_.slotBit(node);
+		return 0;
+	}
+
+	// Sort tous les noeuds de notre réservoir (voir relocateNode()). Au plus InlineCapacity noeuds, donc en O(1).
+	void relocatePoolNodes(PoolType* target) {
+		if constexpr (InlineCapacity > 0)
+			inlineNodes_.forEachNodeInUse([&] (NodeType* node) { relocateNode(node, target); });
+	}
+
+	// Base impaire (donc inversible modulo 2^64) du hachage polynomial, et son inverse calculé par itérations de Newton (chaque itération double le nombre de bits exacts).
+	static constexpr uint64_t hashBase = 0x9E3779B97F4A7C15ull;
+	static constexpr uint64_t computeInverse(uint64_t b) {
+		uint64_t x = b;
+		for (int i = 0; i < 6; i++)
+			x *= 2 - b * x;
+		return x;
+	}
+	static constexpr uint64_t hashBaseInverse = computeInverse(hashBase);
+	static_assert(hashBase * hashBaseInverse == 1);
+
+	static constexpr bool isHashable = requires (const T& value) { std::hash<T>{}(value); };
+
+	// On mélange les bits de std::hash (qui est souvent l'identité pour les entiers) avec le finaliseur de splitmix64.
+	// Pour un T sans std::hash, l'empreinte n'est jamais valide et cette fonction n'est jamais appelée, mais elle doit compiler pour push_back() et compagnie.
+	static uint64_t elementHash([[maybe_unused]] const T& value) {
+		if constexpr (isHashable) {
+			uint64_t h = std::hash<T>{}(value);
+			h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+			h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+			return h ^ (h >> 31);
+		} else {
+			return 0;
+		}
+	}
+
+	void invalidateHash() { hashValid_ = false; }
+
+	// Fusionne deux chaînes triées (reliées seulement par 'next_') dans 'a', en prenant dans 'a' à égalité pour que la fusion soit stable. 'b' se retrouve vide.
+	// Si 'comp' lance une exception, tous les noeuds sont quand même dans 'a' (dans un ordre quelconque) quand elle est relancée.
+	template <typename Compare>
+	static void mergeChains(NodePtr& a, NodePtr& b, Compare& comp) {
+		NodePtr head;
+		NodePtr* tail = &head;
+		try {
+			while (a != nullptr and b != nullptr) {
+				NodePtr& source = comp(b->getValue(), a->getValue()) ? b : a;
+				// On déplace le noeud en tête de 'source' à la fin du résultat, puis on remet le reste de la chaîne dans 'source'.
+				*tail = move(source);
+				source = move((*tail)->next_);
+				tail = &(*tail)->next_;
+			}
+		} catch (...) {
+			appendChain(tail, a);
+			appendChain(tail, b);
+			a = move(head);
+			throw;
+		}
+		*tail = move(a != nullptr ? a : b);
+		a = move(head);
+	}
+
+	// Avance 'tail' jusqu'à la fin de sa chaîne et y accroche 'chain', qui se retrouve vide.
+	static void appendChain(NodePtr*& tail, NodePtr& chain) {
+		while (*tail != nullptr)
+			tail = &(*tail)->next_;
+		*tail = move(chain);
+	}
+
+	// Détache les noeuds de [first, last[ ('last' nul pour aller jusqu'à la fin) et retourne la chaîne qui les possède. Le dernier noeud détaché n'a plus de suivant.
+	// Ne met pas à jour 'size_', c'est à l'appelant de le faire.
+	NodePtr unlinkRange(NodeType* first, NodeType* last) {
+		NodeType* before = first->previous_;
+		NodeType* rangeLast = last != nullptr ? last->previous_ : last_;
+		NodePtr& owner = before != nullptr ? before->next_ : first_;
+
+		NodePtr chain = move(owner);
+		owner = move(rangeLast->next_);
+		if (last != nullptr)
+			last->previous_ = before;
+		else
+			last_ = before;
+		first->previous_ = nullptr;
+		return chain;
+	}
+
+	// Insère la chaîne [head, tail] avant le noeud 'position' (nul pour insérer à la fin). Ne met pas à jour 'size_'.
+	void linkRange(NodeType* position, NodePtr head, NodeType* tail) {
+		NodeType* before = position != nullptr ? position->previous_ : last_;
+		NodePtr& owner = before != nullptr ? before->next_ : first_;
+
+		tail->next_ = move(owner);
+		if (position != nullptr)
+			position->previous_ = tail;
+		else
+			last_ = tail;
+		head->previous_ = before;
+		owner = move(head);
+	}
+
+	// Après avoir relié les noeuds par 'next_' seulement, on refait les 'previous_' et on retrouve le dernier en une passe.
+	void relinkPrevious() {
+		NodeType* previous = nullptr;
+		for (NodeType* node = first_.get(); node != nullptr; node = node->next_.get()) {
+			node->previous_ = previous;
+			previous = node;
+		}
+		last_ = previous;
+	}
+
+	// Déclaré avant 'first_' pour être détruit après les noeuds qu'il contient.
+	UTILS_NO_UNIQUE_ADDRESS ListInlineStorage_impl<T, InlineCapacity> inlineNodes_;
+
+	NodePtr              first_;
 	NodeType*            last_ = nullptr;
 	size_t               size_ = 0;
+
+	// Empreinte en cache (voir contentHash()). 'basePower_' vaut B^size_ quand l'empreinte est valide.
+	bool                 hashCaching_ = false;
+	mutable bool         hashValid_ = false;
+	mutable uint64_t     hash_ = 0;
+	mutable uint64_t     basePower_ = 1;
 };
 
+// Liste qui garde ses 8 premiers éléments sans allocation, pour les nombreuses petites listes.
+template <typename T>
+using SmallList = List<T, 8>;
+
 }
 
 namespace std {
 
-template <typename T>
-struct hash<typename utils::List<T>> {
-	size_t operator()(const utils::List<T>& list) const noexcept {
-		// boost::hash_range est clairement une meilleure idée...
-		size_t result = 0;
-		for (size_t i = 0; auto&& e : list)
-			result ^= hash<T>{}(e) + ++i;
-		return result;
+template <typename T, size_t N>
+struct hash<typename utils::List<T, N>> {
+	size_t operator()(const utils::List<T, N>& list) const noexcept {
+		// En O(1) si la liste garde son empreinte en cache (voir List::enableHashCaching()).
+		return list.contentHash();
 	}
 };
 
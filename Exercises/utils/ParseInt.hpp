@@ -0,0 +1,61 @@
+#pragma once
+
+
+#pragma region "Includes" //{
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+
+#include <charconv>
+#include <climits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+using namespace std;
+
+#pragma endregion //}
+
+
+namespace utils {
+
+// Équivalent de stoi(x, nullptr, 0) sans exception pour le cas courant d'un mot qui n'est pas un nombre : retourne nullopt là où stoi lance invalid_argument.
+// Comme strtol en base 0 (ce que stoi utilise) : un signe optionnel, puis "0x"/"0X" suivi d'au moins un chiffre hexadécimal pour la base 16, sinon un 0 au début pour la base 8, sinon la base 10.
+// Seul le début du mot est lu (ex. "12abc" donne 12, "0xRAWR" donne 0, "09" donne 0).
+// Une valeur qui ne rentre pas dans un int lance out_of_range : on appelle alors stoi pour avoir exactement la même exception (c'est rare, donc le coût ne compte pas).
+inline optional<int> tryParseInt(string_view x) {
+	const char* first = x.data();
+	const char* last = x.data() + x.size();
+	// Comme strtol, on ignore les blancs du début.
+	while (first != last and isspace(static_cast<unsigned char>(*first)))
+		first++;
+
+	bool isNegative = false;
+	if (first != last and (*first == '+' or *first == '-')) {
+		isNegative = *first == '-';
+		first++;
+	}
+
+	int base = 10;
+	if (first != last and *first == '0') {
+		base = 8;
+		if (last - first > 2 and (first[1] == 'x' or first[1] == 'X') and isxdigit(static_cast<unsigned char>(first[2]))) {
+			base = 16;
+			first += 2;
+		}
+	}
+
+	// from_chars n'accepte pas de signe pour un type non signé, donc on lit la valeur absolue et on applique le signe après.
+	unsigned long long magnitude = 0;
+	auto [end, error] = from_chars(first, last, magnitude, base);
+	if (error == errc::invalid_argument)
+		return nullopt;
+	unsigned long long limit = isNegative ? 0ull - (unsigned long long)INT_MIN : (unsigned long long)INT_MAX;
+	if (error == errc::result_out_of_range or magnitude > limit)
+		return stoi(string(x), nullptr, 0);
+	return isNegative ? int(0ull - magnitude) : int(magnitude);
+}
+
+}
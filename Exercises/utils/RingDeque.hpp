@@ -0,0 +1,310 @@
+#pragma once
+
+
+#pragma region "Includes" //{
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <initializer_list>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "List.hpp"
+
+using namespace std;
+
+#pragma endregion //}
+
+
+namespace utils {
+
+template <typename> class RingDeque;
+
+
+// Itérateur à accès direct : on garde l'indice logique (0 = premier élément) plutôt qu'un pointeur, donc il traverse la fin du tampon sans cas particulier.
+template <class DequeT>
+class RingDequeIterator_impl
+{
+	template <typename>
+	friend class RingDeque;
+
+public:
+	using DequeValueType = typename DequeT::value_type;
+	// Comme pour ListIterator_impl, les valeurs sont constantes si la file est constante.
+	using value_type = conditional_t<is_const_v<DequeT>, const DequeValueType, DequeValueType>;
+	using difference_type = ptrdiff_t;
+	using reference = value_type&;
+	using iterator_category = std::random_access_iterator_tag;
+
+	RingDequeIterator_impl() = default;
+	RingDequeIterator_impl(size_t index, DequeT* parent) : index_(index), parent_(parent) { }
+
+	value_type& operator*() const { return (*parent_)[index_]; }
+	value_type& operator[](difference_type offset) const { return (*parent_)[index_ + offset]; }
+
+	RingDequeIterator_impl& operator++() { index_++; return *this; }
+	RingDequeIterator_impl& operator--() { index_--; return *this; }
+	RingDequeIterator_impl operator++(int) { auto old = *this; index_++; return old; }
+	RingDequeIterator_impl operator--(int) { auto old = *this; index_--; return old; }
+
+	RingDequeIterator_impl& operator+=(difference_type offset) { index_ += offset; return *this; }
+	RingDequeIterator_impl& operator-=(difference_type offset) { index_ -= offset; return *this; }
+	friend RingDequeIterator_impl operator+(RingDequeIterator_impl it, difference_type offset) { return it += offset; }
+	friend RingDequeIterator_impl operator+(difference_type offset, RingDequeIterator_impl it) { return it += offset; }
+	friend RingDequeIterator_impl operator-(RingDequeIterator_impl it, difference_type offset) { return it -= offset; }
+	friend difference_type operator-(const RingDequeIterator_impl& lhs, const RingDequeIterator_impl& rhs) { return difference_type(lhs.index_) - difference_type(rhs.index_); }
+
+	bool operator==(const RingDequeIterator_impl& rhs) const { return index_ == rhs.index_ and parent_ == rhs.parent_; }
+	auto operator<=>(const RingDequeIterator_impl& rhs) const { return index_ <=> rhs.index_; }
+
+private:
+	size_t  index_ = 0;
+	DequeT* parent_ = nullptr;
+};
+
+
+// File à double entrée dans un tampon circulaire contigu, avec la même interface que List (push/pop aux deux bouts, itération, <<, EmptyListError).
+// Les valeurs sont côte à côte en mémoire, sans noeud ni pointeurs : pour des int, ça prend environ 4 octets par élément au lieu d'un noeud alloué de 32 octets et plus, et un parcours lit la mémoire séquentiellement.
+// La capacité est une puissance de 2 (on remplace le modulo par un masque) et double quand le tampon est plein, donc push_back/push_front sont en O(1) amorti.
+// Contrairement à List, ajouter un élément peut déplacer les autres et invalider les itérateurs.
+template <typename T>
+class RingDeque
+{
+public:
+	using value_type = T;
+	using iterator = RingDequeIterator_impl<RingDeque>;
+	using const_iterator = RingDequeIterator_impl<const RingDeque>;
+
+	RingDeque() = default;
+
+	RingDeque(const RingDeque& other) {
+		*this = other;
+	}
+
+	RingDeque(RingDeque&& other) noexcept {
+		*this = move(other);
+	}
+
+	RingDeque(initializer_list<value_type> elements) {
+		*this = elements;
+	}
+
+	~RingDeque() {
+		clear();
+		deallocate(data_, capacity_);
+	}
+
+	RingDeque& operator=(const RingDeque& other) {
+		if (&other == this)
+			return *this;
+
+		clear();
+		reserve(other.size());
+		for (auto&& e : other)
+			push_back(e);
+		return *this;
+	}
+
+	RingDeque& operator=(RingDeque&& other) noexcept {
+		if (&other == this)
+			return *this;
+
+		clear();
+		deallocate(data_, capacity_);
+		data_ = exchange(other.data_, nullptr);
+		capacity_ = exchange(other.capacity_, 0);
+		head_ = exchange(other.head_, 0);
+		size_ = exchange(other.size_, 0);
+		return *this;
+	}
+
+	RingDeque& operator=(initializer_list<value_type> elements) {
+		clear();
+		reserve(elements.size());
+		for (auto&& e : elements)
+			push_back(e);
+		return *this;
+	}
+
+	iterator begin() { return iterator(0, this); }
+	iterator end() { return iterator(size_, this); }
+	const_iterator begin() const { return const_iterator(0, this); }
+	const_iterator end() const { return const_iterator(size_, this); }
+
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+	size_t capacity() const { return capacity_; }
+
+	// Accès par indice logique (0 = premier élément), sans vérification, comme vector::operator[].
+	T& operator[](size_t index) { return data_[(head_ + index) & (capacity_ - 1)]; }
+	const T& operator[](size_t index) const { return data_[(head_ + index) & (capacity_ - 1)]; }
+
+	void clear() {
+		for (size_t i = 0; i < size_; i++)
+			destroy_at(&(*this)[i]);
+		head_ = 0;
+		size_ = 0;
+	}
+
+	// Garantit de la place pour 'capacity' éléments sans réallocation.
+	void reserve(size_t capacity) {
+		if (capacity > capacity_)
+			reallocate(bit_ceil(capacity));
+	}
+
+	void resize(size_t size) {
+		while (size_ > size)
+			pop_back();
+		reserve(size);
+		while (size_ < size)
+			push_back(T{});
+	}
+
+	void push_front(const T& valeur) {
+		emplace_front(valeur);
+	}
+
+	void push_front(T&& valeur) {
+		emplace_front(move(valeur));
+	}
+
+	void push_back(const T& valeur) {
+		emplace_back(valeur);
+	}
+
+	void push_back(T&& valeur) {
+		emplace_back(move(valeur));
+	}
+
+	template <typename... Args>
+	T& emplace_front(Args&&... args) {
+		if (size_ == capacity_)
+			return growAndEmplace(true, forward<Args>(args)...);
+		size_t newHead = (head_ - 1) & (capacity_ - 1);
+		T* element = construct_at(&data_[newHead], forward<Args>(args)...);
+		head_ = newHead;
+		size_++;
+		return *element;
+	}
+
+	template <typename... Args>
+	T& emplace_back(Args&&... args) {
+		if (size_ == capacity_)
+			return growAndEmplace(false, forward<Args>(args)...);
+		T* element = construct_at(&(*this)[size_], forward<Args>(args)...);
+		size_++;
+		return *element;
+	}
+
+	void pop_front() {
+		if (empty())
+			throw EmptyListError(EmptyListError::popMessage);
+		destroy_at(&data_[head_]);
+		head_ = (head_ + 1) & (capacity_ - 1);
+		size_--;
+	}
+
+	void pop_back() {
+		if (empty())
+			throw EmptyListError(EmptyListError::popMessage);
+		destroy_at(&(*this)[size_ - 1]);
+		size_--;
+	}
+
+	// Comme List::try_pop_front()/try_pop_back() : la valeur enlevée, ou nullopt (sans exception) si la file est vide.
+	optional<T> try_pop_front() {
+		if (empty())
+			return nullopt;
+		optional<T> value(move(data_[head_]));
+		pop_front();
+		return value;
+	}
+
+	optional<T> try_pop_back() {
+		if (empty())
+			return nullopt;
+		optional<T> value(move((*this)[size_ - 1]));
+		pop_back();
+		return value;
+	}
+
+	bool operator==(const RingDeque& rhs) const {
+		return size() == rhs.size() and equal(begin(), end(), rhs.begin());
+	}
+
+	bool operator<(const RingDeque& rhs) const {
+		return lexicographical_compare(begin(), end(), rhs.begin(), rhs.end());
+	}
+
+	// Même format que List.
+	friend ostream& operator<<(ostream& lhs, const RingDeque& rhs) {
+		auto printWidth = lhs.width();
+		lhs << "[";
+		printElements_impl(lhs, rhs.begin(), rhs.end(), printWidth);
+		lhs << "]";
+		return lhs;
+	}
+
+private:
+	static constexpr size_t initialCapacity = 16;
+
+	static T* allocate(size_t capacity) {
+		return allocator<T>().allocate(capacity);
+	}
+
+	static void deallocate(T* data, size_t capacity) {
+		if (data != nullptr)
+			allocator<T>().deallocate(data, capacity);
+	}
+
+	// Double la capacité en ajoutant un élément au début ('atFront') ou à la fin.
+	// Le nouvel élément est construit dans le nouveau tampon avant qu'on déplace les autres : 'args' peut faire référence à un élément de la file (ex. d.push_back(d[0])), qui doit encore être à sa place à ce moment, comme avec vector.
+	template <typename... Args>
+	T& growAndEmplace(bool atFront, Args&&... args) {
+		size_t newCapacity = capacity_ == 0 ? initialCapacity : capacity_ * 2;
+		T* newData = allocate(newCapacity);
+		T* element;
+		try {
+			element = construct_at(&newData[atFront ? 0 : size_], forward<Args>(args)...);
+		} catch (...) {
+			deallocate(newData, newCapacity);
+			throw;
+		}
+		moveTo(newData, newCapacity, atFront ? 1 : 0);
+		size_++;
+		return *element;
+	}
+
+	void reallocate(size_t newCapacity) {
+		moveTo(allocate(newCapacity), newCapacity, 0);
+	}
+
+	// Déplace les éléments dans un nouveau tampon à partir de l'indice 'offset' (ils ne sont donc plus coupés en deux par la fin du tampon), qui remplace l'ancien.
+	void moveTo(T* newData, size_t newCapacity, size_t offset) {
+		for (size_t i = 0; i < size_; i++) {
+			T& element = (*this)[i];
+			construct_at(&newData[offset + i], move_if_noexcept(element));
+			destroy_at(&element);
+		}
+		deallocate(data_, capacity_);
+		data_ = newData;
+		capacity_ = newCapacity;
+		head_ = 0;
+	}
+
+	T*     data_ = nullptr;
+	size_t capacity_ = 0;
+	size_t head_ = 0;
+	size_t size_ = 0;
+};
+
+}
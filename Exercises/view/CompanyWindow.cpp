@@ -5,6 +5,10 @@
 #include <string>
 #include <ranges>
 #include <algorithm>
+#include <chrono>
+
+#include <QMetaObject>
+#include <QStatusBar>
 
 #include <cppitertools/itertools.hpp>
 
@@ -12,6 +16,7 @@
 #include <company/Employee.hpp>
 #include <company/Secretary.hpp>
 #include <company/Manager.hpp>
+#include <utils/LatencyHistogram.hpp>
 
 #include "CompanyWindow.hpp"
 #include "ui_CompanyWindow.h"
@@ -44,11 +49,22 @@ CompanyWindow::CompanyWindow(unique_ptr<Company> companyRes, Company* company, Q
 	// On connecte les signaux de notre company aux slots créés localement pour agir suite à ces signaux.
 	connect(company_, SIGNAL(employeeAdded(Employee*)), this, SLOT(employeeHasBeenAdded(Employee*)));
 	connect(company_, SIGNAL(employeeDeleted(Employee*)), this, SLOT(employeeHasBeenDeleted(Employee*)));
+	connect(company_, SIGNAL(employeesMerged(int, int)), this, SLOT(employeesHaveBeenMerged(int, int)));
+	connect(company_, SIGNAL(employeeSalaryChanged(Employee*)), this, SLOT(employeeSalaryHasChanged(Employee*)));
+	connect(company_, SIGNAL(employeeDestroyed(Employee*)), this, SLOT(employeeHasBeenDestroyed(Employee*)));
 
-	loadEmployees();
+	// Pour une grosse compagnie, on ne bloque pas le constructeur : la fenêtre s'affiche tout de suite et se remplit progressivement.
+	if (company_->getNumberEmployees() > asyncLoadingThreshold)
+		loadEmployeesAsync();
+	else
+		loadEmployees();
 }
 
-CompanyWindow::~CompanyWindow() { }
+CompanyWindow::~CompanyWindow() {
+	stopLoading();
+	// Nos employés sont détruits avec nos attributs, avant que QObject ne déconnecte la fenêtre : on ne veut plus recevoir employeeDestroyed à ce moment.
+	disconnect(company_, nullptr, this, nullptr);
+}
 
 void CompanyWindow::setupMenu() {
 	ui_->actionExit->setShortcuts(QKeySequence::Quit);
@@ -58,6 +74,9 @@ void CompanyWindow::setupUi() {
 	// Le sélecteur pour filtrer ce que l'on souhaite dans la liste
 	connect(ui_->showCombobox, SIGNAL(currentIndexChanged(int)), this, SLOT(filterList(int)));
 
+	// Le sélecteur du critère de tri de la liste
+	connect(ui_->sortCombobox, SIGNAL(currentIndexChanged(int)), this, SLOT(sortList(int)));
+
 	// La liste des employés
 	connect(ui_->employeesList, SIGNAL(itemClicked(QListWidgetItem*)), this, SLOT(selectEmployee(QListWidgetItem*)));
 
@@ -87,12 +106,19 @@ void CompanyWindow::setupUi() {
 	QString title = "Employee Manager for " + QString(company_->getName().c_str());
 	setWindowTitle(title);
 
+	// La barre de progression du chargement en arrière-plan, cachée le reste du temps.
+	loadingProgress_ = new QProgressBar(this);
+	loadingProgress_->setMaximumWidth(200);
+	loadingProgress_->hide();
+	statusBar()->addPermanentWidget(loadingProgress_);
+
 	cleanDisplay();
 }
 
 void CompanyWindow::loadEmployees() {
 	// On s'assure que la liste est vide.
 	ui_->employeesList->clear();
+	items_.clear();
 	// Puis, pour tous les employés dans Company:
 	int max = company_->getNumberEmployees();
 	for (int i : range(max)) {
@@ -102,9 +128,180 @@ void CompanyWindow::loadEmployees() {
 			continue;
 		// Et on l'ajoute en tant qu'item de la liste:
 		// le nom sera affiché, et le pointeur sera contenu.
-		QListWidgetItem* item = new QListWidgetItem(QString::fromStdString(employee->getName()), ui_->employeesList);
-		item->setData(Qt::UserRole, QVariant::fromValue<Employee*>(employee));
-		item->setHidden(filterHide(employee));
+		addItem(QString::fromStdString(employee->getName()), employee, EmployeeSortKeys::of(*employee));
+	}
+}
+
+void CompanyWindow::loadEmployeesAsync() {
+	stopLoading();
+	ui_->employeesList->clear();
+	items_.clear();
+
+	// On ne copie ici que les pointeurs (ou rien, si la compagnie publie déjà des versions de sa liste).
+	// Les employés eux-mêmes sont lus un lot à la fois, dans readNextFields, pour ne pas bloquer l'interface.
+	shared_ptr<const vector<Employee*>> roster;
+	if (company_->areSnapshotsEnabled())
+		roster = company_->getSnapshot();
+	else {
+		auto employees = make_shared<vector<Employee*>>();
+		employees->reserve(company_->getNumberEmployees());
+		for (int i : range(company_->getNumberEmployees()))
+			employees->push_back(company_->getEmployee(i));
+		roster = std::move(employees);
+	}
+
+	int total = int(roster->size());
+	int generation = ++loadingGeneration_;
+	isLoading_ = true;
+	batchesInFlight_ = 0;
+	// Le tri à chaque insertion coûterait O(n) par item : le fil de chargement trie les items avant de les envoyer, et la liste les reçoit dans l'ordre.
+	ui_->employeesList->setSortingEnabled(false);
+	// La première moitié de la barre pour la lecture des employés, la seconde pour l'affichage.
+	loadingProgress_->setRange(0, 2 * total);
+	loadingProgress_->setValue(0);
+	loadingProgress_->show();
+
+	if (total == 0) {
+		stopLoading();
+		ui_->employeesList->setSortingEnabled(true);
+		return;
+	}
+
+	// Le fil de chargement ne touche ni à la compagnie ni aux employés : il ne reçoit que les copies lues par readNextFields.
+	// Il en fait les QString et les clés de tri, trie le tout selon le critère actuel, puis renvoie les items à l'interface, lot par lot, dans l'ordre.
+	loader_ = jthread([this, sortKey = sortKey_, generation] (stop_token stop) {
+		static constexpr int maxBatchesInFlight = 2;
+		vector<PreparedItem> prepared;
+		for (bool isLast = false; not isLast; ) {
+			FieldsBatch fields;
+			{
+				unique_lock lock(fieldsMutex_);
+				if (not fieldsReady_.wait(lock, stop, [this] { return not pendingFields_.empty(); }))
+					return;
+				fields = std::move(pendingFields_.front());
+				pendingFields_.pop_front();
+			}
+			for (const EmployeeFields& employee : fields.fields)
+				prepared.push_back({QString::fromStdString(employee.label), employee.employee, EmployeeSortKeys::of(employee.name, employee.salary, employee.role)});
+			isLast = fields.isLast;
+		}
+		ranges::stable_sort(prepared, [sortKey] (const PreparedItem& lhs, const PreparedItem& rhs) {
+			return lhs.keys.precedes(rhs.keys, sortKey);
+		});
+
+		// Au moins un lot, même vide, pour que l'interface termine le chargement.
+		int nPrepared = int(prepared.size());
+		int begin = 0;
+		do {
+			int end = min(begin + loadingBatchSize, nPrepared);
+			vector<PreparedItem> batch(make_move_iterator(prepared.begin() + begin), make_move_iterator(prepared.begin() + end));
+
+			while (batchesInFlight_ >= maxBatchesInFlight and not stop.stop_requested())
+				this_thread::sleep_for(1ms);
+			if (stop.stop_requested())
+				return;
+			batchesInFlight_++;
+			// Le lot est ajouté dans le fil de l'interface. Si la fenêtre est détruite entre-temps, Qt abandonne l'appel.
+			QMetaObject::invokeMethod(this, [this, batch = std::move(batch), end, nPrepared, sortKey, generation] {
+				appendPreparedBatch(batch, end, nPrepared, sortKey, generation);
+			}, Qt::QueuedConnection);
+			begin = end;
+		} while (begin < nPrepared);
+	});
+
+	readNextFields(roster, 0, generation);
+}
+
+void CompanyWindow::readNextFields(const shared_ptr<const vector<Employee*>>& roster, int begin, int generation) {
+	// Lecture d'un chargement annulé ou remplacé.
+	if (generation != loadingGeneration_)
+		return;
+
+	int total = int(roster->size());
+	int end = min(begin + loadingBatchSize, total);
+	FieldsBatch batch = {{}, end == total};
+	batch.fields.reserve(end - begin);
+	for (int i = begin; i < end; i++) {
+		Employee* employee = (*roster)[i];
+		// Un employé congédié ou détruit depuis le début du chargement n'est plus lu (il n'existe peut-être plus).
+		if (employee != nullptr and not deletedWhileLoading_.contains(employee))
+			batch.fields.push_back({employee, employee->getName(), employee->Employee::getName(), employee->getSalaryCents(), employee->getRole()});
+	}
+	{
+		lock_guard lock(fieldsMutex_);
+		pendingFields_.push_back(std::move(batch));
+	}
+	fieldsReady_.notify_one();
+	loadingProgress_->setValue(end);
+
+	// Le lot suivant est lu au prochain tour de la boucle d'événements : l'interface reste réactive entre deux lots.
+	if (end < total) {
+		QMetaObject::invokeMethod(this, [this, roster, end, generation] {
+			readNextFields(roster, end, generation);
+		}, Qt::QueuedConnection);
+	}
+}
+
+void CompanyWindow::stopLoading() {
+	if (loader_.joinable()) {
+		loader_.request_stop();
+		loader_.join();
+	}
+	// Les lots encore en attente dans la boucle d'événements seront ignorés.
+	loadingGeneration_++;
+	isLoading_ = false;
+	deletedWhileLoading_.clear();
+	unsortedWhileLoading_.clear();
+	{
+		lock_guard lock(fieldsMutex_);
+		pendingFields_.clear();
+	}
+	if (loadingProgress_ != nullptr)
+		loadingProgress_->hide();
+}
+
+void CompanyWindow::appendPreparedBatch(const vector<PreparedItem>& batch, int nLoaded, int nTotal, EmployeeSortKey preparedSortKey, int generation) {
+	// Lot d'un chargement annulé ou remplacé.
+	if (generation != loadingGeneration_)
+		return;
+	batchesInFlight_--;
+
+	for (const PreparedItem& prepared : batch) {
+		if (deletedWhileLoading_.contains(prepared.employee))
+			continue;
+		EmployeeListItem* item = addItem(prepared.label, prepared.employee, prepared.keys);
+		// Le salaire a pu changer depuis que l'employé a été lu : on le relit ici, dans le fil de l'interface (l'employé n'a pas été détruit, sinon il serait dans deletedWhileLoading_).
+		// L'item n'est alors plus à sa place dans l'ordre du lot.
+		if (Cents salary = prepared.employee->getSalaryCents(); salary != prepared.keys.salary) {
+			item->setSalary(salary);
+			unsortedWhileLoading_.insert(item);
+		}
+	}
+	int half = loadingProgress_->maximum() / 2;
+	loadingProgress_->setValue(half + int(int64_t(half) * nLoaded / max(nTotal, 1)));
+
+	// Dernier lot : le fil a terminé, on remet la liste dans son état normal.
+	if (nLoaded == nTotal)
+		finishLoading(preparedSortKey);
+}
+
+void CompanyWindow::finishLoading(EmployeeSortKey preparedSortKey) {
+	vector<EmployeeListItem*> unsorted(unsortedWhileLoading_.begin(), unsortedWhileLoading_.end());
+	stopLoading();
+	QListWidget* list = ui_->employeesList;
+	list->setSortingEnabled(true);
+
+	// Le critère de tri a changé pendant le chargement : les lots ont été triés selon l'ancien.
+	if (sortKey_ != preparedSortKey) {
+		list->sortItems();
+		return;
+	}
+	// Sinon, les lots sont arrivés dans l'ordre et la liste est déjà triée, sauf les items ajoutés ou modifiés entre-temps.
+	// On ne remet à leur place que ceux-là (recherche binaire), au lieu de retrier toute la liste.
+	for (EmployeeListItem* item : unsorted) {
+		list->takeItem(list->row(item));
+		list->addItem(item);
+		item->setHidden(filterHide(item->getEmployee()));
 	}
 }
 
@@ -116,6 +313,26 @@ bool CompanyWindow::filterHide(Employee* employee) {
 	return not employeeCategories_[currentFilterIndex_ - 1].employees->contains(employee);
 }
 
+EmployeeListItem* CompanyWindow::addItem(const QString& label, Employee* employee, EmployeeSortKeys keys) {
+	auto* item = new EmployeeListItem(label, employee, std::move(keys), sortKey_);
+	item->setData(Qt::UserRole, QVariant::fromValue<Employee*>(employee));
+	// Avec le tri activé, la liste insère l'item directement à sa place (recherche binaire).
+	ui_->employeesList->addItem(item);
+	// setHidden n'a d'effet qu'une fois l'item dans la liste.
+	item->setHidden(filterHide(employee));
+	items_.emplace(employee, item);
+	return item;
+}
+
+void CompanyWindow::sortList(int index) {
+	UTILS_MEASURE_LATENCY("CompanyWindow::sortList");
+	// Les items comparent leurs clés précalculées selon sortKey_, donc changer de critère ne fait que retrier les pointeurs.
+	sortKey_ = EmployeeSortKey(index);
+	// Pendant un chargement, le tri est fait une seule fois à la fin (les lots arrivent triés selon l'ancien critère).
+	if (not isLoading_)
+		ui_->employeesList->sortItems();
+}
+
 void CompanyWindow::filterList(int index) {
 	// On met à jour l'indice de filtre actuel
 	currentFilterIndex_ = index;
@@ -230,39 +447,81 @@ void CompanyWindow::hireNewEmployee() {
 }
 
 void CompanyWindow::employeeHasBeenAdded(Employee* employee) {
-	// On ajoute le nouvel employé comme item de la QListWidget
-	QListWidgetItem* item = new QListWidgetItem(
-		QString::fromStdString(employee->getName()), ui_->employeesList);
-	item->setData(Qt::UserRole, QVariant::fromValue<Employee*>(employee));
+	UTILS_MEASURE_LATENCY("CompanyWindow::employeeHasBeenAdded");
+	// On ajoute le nouvel employé comme item de la QListWidget, à sa place selon le tri (sans retrier la liste),
+	// et visible ou non selon le filtre actuel.
+	EmployeeListItem* item = addItem(QString::fromStdString(employee->getName()), employee, EmployeeSortKeys::of(*employee));
+	// Pendant un chargement, le tri est désactivé et l'item est ajouté à la fin.
+	if (isLoading_)
+		unsortedWhileLoading_.insert(item);
+}
 
-	// On change la visibilité de notre nouvel employé selon
-	// le filtre actuel
-	item->setHidden(filterHide(employee));
+void CompanyWindow::employeeSalaryHasChanged(Employee* employee) {
+	// Changer la clé de l'item signale à la liste de le remettre à sa place, seulement lui.
+	auto [first, last] = items_.equal_range(employee);
+	for (auto it = first; it != last; ++it) {
+		it->second->setSalary(employee->getSalaryCents());
+		// Sauf pendant un chargement, où le tri est désactivé.
+		if (isLoading_)
+			unsortedWhileLoading_.insert(it->second);
+	}
+}
+
+void CompanyWindow::employeesHaveBeenMerged(int firstIndex, int count) {
+	UTILS_MEASURE_LATENCY("CompanyWindow::employeesHaveBeenMerged");
+	// Pour une grosse fusion, on recharge la liste en arrière-plan plutôt que de bloquer l'interface.
+	if (count > asyncLoadingThreshold) {
+		loadEmployeesAsync();
+		return;
+	}
+	// Sinon, on ajoute les items d'un coup, sans redessiner la liste à chaque item.
+	ui_->employeesList->setUpdatesEnabled(false);
+	for (int i = firstIndex; i < firstIndex + count; i++)
+		employeeHasBeenAdded(company_->getEmployee(i));
+	ui_->employeesList->setUpdatesEnabled(true);
 }
 
 void CompanyWindow::employeeHasBeenDeleted(Employee* e) {
-	// On cherche dans notre QlistWidget l'employé pour lequel le
-	// signal a été envoyé, afin de l'en retirer
-	for (int i = 0; i < ui_->employeesList->count(); ++i) {
-		QListWidgetItem *item = ui_->employeesList->item(i);
-		Employee* employee = item->data(Qt::UserRole).value<Employee*>();
-		if (employee == e) {
-			// delete sur un QlistWidget item va automatiquement le retirer de la liste
-			delete item;
-			// Si l'employé faisait partie de ceux créés localement, on veut le supprimer.
-			auto it = std::find_if(added_.begin(), added_.end(), [&] (auto& arg) { return arg.get() == e; });
-			if (it != added_.end()) {
-				added_.erase(it);
-			}
-			// L'employé ne devrait être qu'une fois dans la liste...
-			break;
-		}
+	UTILS_MEASURE_LATENCY("CompanyWindow::employeeHasBeenDeleted");
+	// On cherche l'item de l'employé pour lequel le signal a été envoyé, afin de le retirer
+	// (un seul : l'employé est peut-être encore ailleurs dans la compagnie)
+	auto item = items_.find(e);
+	bool found = item != items_.end();
+	if (found) {
+		// delete sur un QlistWidget item va automatiquement le retirer de la liste
+		unsortedWhileLoading_.erase(item->second);
+		delete item->second;
+		items_.erase(item);
 	}
+	// Pendant un chargement en arrière-plan, l'employé n'a peut-être pas encore été affiché : on s'assure que son lot l'ignorera.
+	if (isLoading_ and not found)
+		deletedWhileLoading_.insert(e);
+
+	// Si l'employé faisait partie de ceux créés localement, on veut le supprimer.
+	auto it = std::find_if(added_.begin(), added_.end(), [&] (auto& arg) { return arg.get() == e; });
+	if (it != added_.end())
+		added_.erase(it);
 	// On remet à zéro l'affichage de la colonne de gauche étant
 	// donné que les employés sélectionnés ont été supprimés
 	cleanDisplay();
 }
 
+void CompanyWindow::employeeHasBeenDestroyed(Employee* e) {
+	// L'employé est dans son destructeur : on ne garde aucun pointeur vers lui, et on n'utilise que son adresse.
+	auto [first, last] = items_.equal_range(e);
+	for (auto it = first; it != last; ++it) {
+		unsortedWhileLoading_.erase(it->second);
+		delete it->second;
+	}
+	items_.erase(first, last);
+	// Toutes ses occurrences ont été retirées de la compagnie, y compris celles dont le lot n'est pas encore arrivé.
+	if (isLoading_)
+		deletedWhileLoading_.insert(e);
+	for (auto&& cat : employeeCategories_)
+		cat.employees->erase(e);
+	cleanDisplay();
+}
+
 Employee* CompanyWindow::createEmployee(const string& type, const string& name, double salary, double bonus) {
 	unique_ptr<Employee> newEmployee;
 
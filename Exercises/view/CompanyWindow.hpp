@@ -2,16 +2,25 @@
 
 #include <memory>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
+#include <deque>
 #include <span>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <QMainWindow>
 #include <QListWidget>
 #include <QString>
 #include <QRadioButton>
+#include <QProgressBar>
 
 #include <company/Company.hpp>
 
+#include "EmployeeListItem.hpp"
+
 using namespace std;
 
 
@@ -27,6 +36,11 @@ class CompanyWindow : public QMainWindow {
 	Q_OBJECT
 
 public:
+	// Au-delà de ce nombre d'employés, la liste est chargée en arrière-plan plutôt que dans le constructeur.
+	static inline int asyncLoadingThreshold = 2'000;
+	// Nombre d'employés préparés par le fil de chargement avant d'être envoyés à l'interface.
+	static inline int loadingBatchSize = 500;
+
 	CompanyWindow(QWidget* parent = nullptr);
 	CompanyWindow(unique_ptr<Company> company, QWidget* parent = nullptr);
 	CompanyWindow(Company* company, QWidget* parent = nullptr);
@@ -38,6 +52,10 @@ public slots:
 	 * @brief filterList Slot to filter the list according to the received parameter
 	 */
 	void filterList(int);
+	/**
+	 * @brief sortList Slot to sort the list by name, salary or role (the index in the sort selector)
+	 */
+	void sortList(int);
 	/**
 	 * @brief selectEmployee Slot to select an employee given a QListWidgetItem
 	 */
@@ -70,6 +88,22 @@ public slots:
 	 * @brief employeeHasBeenDeleted To run when an employee has been deleted
 	 */
 	void employeeHasBeenDeleted(Employee*);
+	/**
+	 * @brief employeeHasBeenDestroyed To run when an employee still in the company is being destroyed by its owner
+	 */
+	void employeeHasBeenDestroyed(Employee*);
+	/**
+	 * @brief employeesHaveBeenMerged To run when employees have been added all at once by Company::merge
+	 */
+	void employeesHaveBeenMerged(int firstIndex, int count);
+	/**
+	 * @brief employeeSalaryHasChanged To run when the salary of an employee has changed, to move it in the list if needed
+	 */
+	void employeeSalaryHasChanged(Employee*);
+	/**
+	 * @brief loadEmployeesAsync To (re)load the list in the background, batch by batch, with a progress bar
+	 */
+	void loadEmployeesAsync();
 	Employee* createEmployee(const string& type, const string& name, double salary, double bonus = 0);
 	void fireEmployees(span<Employee*>);
 
@@ -80,12 +114,39 @@ private:
 		QRadioButton*             radioButton;
 	};
 
+	// Ce que le fil de l'interface lit de chaque employé pendant un chargement : le fil de chargement ne travaille que sur cette copie, jamais sur les employés (qui peuvent changer ou être détruits pendant ce temps).
+	struct EmployeeFields {
+		Employee* employee;
+		string    label;
+		string    name;
+		Cents     salary;
+		Role      role;
+	};
+
+	// Un lot d'employés lu par le fil de l'interface, en attente du fil de chargement.
+	struct FieldsBatch {
+		vector<EmployeeFields> fields;
+		bool                   isLast;
+	};
+
+	// Ce que le fil de chargement prépare pour chaque employé : le texte à afficher (la conversion en QString est faite hors du fil de l'interface).
+	struct PreparedItem {
+		QString          label;
+		Employee*        employee;
+		EmployeeSortKeys keys;
+	};
+
 	CompanyWindow(unique_ptr<Company> companyRes, Company* company, QWidget* parent);
 
 	void setupMenu();
 	void setupUi();
 	void loadEmployees();
+	void stopLoading();
+	void readNextFields(const shared_ptr<const vector<Employee*>>& roster, int begin, int generation);
+	void appendPreparedBatch(const vector<PreparedItem>& batch, int nLoaded, int nTotal, EmployeeSortKey preparedSortKey, int generation);
+	void finishLoading(EmployeeSortKey preparedSortKey);
 	bool filterHide(Employee* employee);
+	EmployeeListItem* addItem(const QString& label, Employee* employee, EmployeeSortKeys keys);
 
 	unique_ptr<Ui::CompanyWindow> ui_;
 	unique_ptr<Company> companyRessource_;
@@ -96,6 +157,25 @@ private:
 	unordered_set<Employee*> secretaries_;
 	unordered_set<Employee*> otherEmployees_;
 	vector<EmployeeCategory> employeeCategories_;
+	EmployeeSortKey sortKey_ = EmployeeSortKey::name;
+	// Les items de chaque employé (plusieurs si l'employé est plusieurs fois dans la compagnie), pour les trouver sans parcourir la liste.
+	unordered_multimap<Employee*, EmployeeListItem*> items_;
+
+	QProgressBar* loadingProgress_ = nullptr;
+	bool isLoading_ = false;
+	int loadingGeneration_ = 0;
+	// Nombre de lots envoyés à l'interface mais pas encore affichés. Le fil de chargement attend s'il prend trop d'avance pour ne pas inonder la boucle d'événements.
+	atomic<int> batchesInFlight_ = 0;
+	// Employés congédiés ou détruits avant que leur lot ne soit lu ou n'arrive.
+	unordered_set<Employee*> deletedWhileLoading_;
+	// Items ajoutés ou dont le salaire a changé pendant le chargement, alors que le tri était désactivé : ils seront remis à leur place à la fin.
+	unordered_set<EmployeeListItem*> unsortedWhileLoading_;
+	// Les lots lus par le fil de l'interface, que le fil de chargement attend.
+	mutex fieldsMutex_;
+	condition_variable_any fieldsReady_;
+	deque<FieldsBatch> pendingFields_;
+	// Déclaré en dernier pour être détruit (donc arrêté et joint) en premier.
+	jthread loader_;
 };
 
 }
@@ -0,0 +1,79 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "EmployeeListItem.hpp"
+
+using namespace std;
+
+
+namespace view {
+
+EmployeeSortKeys EmployeeSortKeys::of(const Employee& employee) {
+	return of(employee.Employee::getName(), employee.getSalaryCents(), employee.getRole());
+}
+
+EmployeeSortKeys EmployeeSortKeys::of(const string& name, Cents salary, Role role) {
+	EmployeeSortKeys keys;
+	keys.name = QString::fromStdString(name).toCaseFolded();
+	// Les caractères UTF-16 les plus significatifs en premier, pour que l'ordre des préfixes soit celui de QString::compare.
+	for (int i = 0; i < 4; i++)
+		keys.namePrefix = (keys.namePrefix << 16) | (i < keys.name.size() ? keys.name[i].unicode() : 0);
+	keys.salary = salary;
+	keys.role = role;
+	return keys;
+}
+
+bool EmployeeSortKeys::precedes(const EmployeeSortKeys& other, EmployeeSortKey sortKey) const {
+	const EmployeeSortKeys& lhs = *this;
+	const EmployeeSortKeys& rhs = other;
+	auto compareNames = [&] {
+		if (lhs.namePrefix != rhs.namePrefix)
+			return lhs.namePrefix < rhs.namePrefix ? -1 : 1;
+		return lhs.name.compare(rhs.name);
+	};
+	// À critère égal, on départage par le nom (puis par le salaire pour le tri par nom), pour un ordre qui ne dépend pas de l'ordre d'ajout.
+	switch (sortKey) {
+	case EmployeeSortKey::name:
+		if (int order = compareNames(); order != 0)
+			return order < 0;
+		return lhs.salary < rhs.salary;
+	case EmployeeSortKey::salary:
+		if (lhs.salary != rhs.salary)
+			return lhs.salary < rhs.salary;
+		return compareNames() < 0;
+	case EmployeeSortKey::role:
+		if (lhs.role != rhs.role)
+			return lhs.role < rhs.role;
+		return compareNames() < 0;
+	}
+	return false;
+}
+
+EmployeeListItem::EmployeeListItem(const QString& label, Employee* employee, EmployeeSortKeys keys, const EmployeeSortKey& sortKey)
+: QListWidgetItem(label, nullptr, Type),
+  employee_(employee),
+  keys_(std::move(keys)),
+  sortKey_(sortKey) {
+	setData(SalaryRole, qlonglong(keys_.salary));
+}
+
+Employee* EmployeeListItem::getEmployee() const {
+	return employee_;
+}
+
+const EmployeeSortKeys& EmployeeListItem::getKeys() const {
+	return keys_;
+}
+
+void EmployeeListItem::setSalary(Cents salary) {
+	keys_.salary = salary;
+	setData(SalaryRole, qlonglong(salary));
+}
+
+bool EmployeeListItem::operator<(const QListWidgetItem& other) const {
+	if (other.type() != Type)
+		return QListWidgetItem::operator<(other);
+	return keys_.precedes(static_cast<const EmployeeListItem&>(other).keys_, sortKey_);
+}
+
+}
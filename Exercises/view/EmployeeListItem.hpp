@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+#include <QListWidgetItem>
+#include <QString>
+
+#include <company/Employee.hpp>
+#include <company/Money.hpp>
+
+using namespace std;
+
+
+namespace view {
+
+using namespace company;
+
+// Critère de tri de la liste des employés, dans l'ordre du sélecteur de tri.
+enum class EmployeeSortKey { name, salary, role };
+
+// Clés de tri d'un employé, calculées une seule fois par employé (le fil de chargement les calcule hors du fil de l'interface).
+// Comparer deux items ne fait alors ni appel virtuel, ni allocation, ni conversion en QString.
+struct EmployeeSortKeys {
+	uint64_t namePrefix = 0;        // Les 4 premiers caractères du nom normalisé, comparés d'un coup.
+	QString  name;                  // Le nom normalisé (sans statut, casse repliée), pour départager les préfixes égaux.
+	Cents    salary = 0;            // Le salaire avec bonus, en cents.
+	Role     role = Role::employee;
+
+	static EmployeeSortKeys of(const Employee& employee);
+	// À partir de valeurs déjà lues de l'employé (Employee::getName() pour le nom), donc utilisable dans un autre fil que celui qui modifie l'employé.
+	static EmployeeSortKeys of(const string& name, Cents salary, Role role);
+
+	// L'ordre des items selon le critère donné : EmployeeListItem::operator< l'utilise, et le fil de chargement aussi pour trier ses lots sans créer d'items.
+	bool precedes(const EmployeeSortKeys& other, EmployeeSortKey sortKey) const;
+};
+
+// Item de la liste des employés, trié selon le critère choisi dans la fenêtre.
+// Avec le tri activé, QListWidget insère un nouvel item directement à sa place et ne déplace qu'un item dont les données changent : la liste n'est jamais triée au complet pour un seul employé.
+class EmployeeListItem : public QListWidgetItem {
+public:
+	static constexpr int Type = QListWidgetItem::UserType + 1;
+	// Rôle de données du salaire : le changer (setSalary) signale à la liste que l'item doit peut-être se déplacer.
+	static constexpr int SalaryRole = Qt::UserRole + 1;
+
+	// L'item doit être ajouté à la liste après sa construction (addItem) : pendant la construction de QListWidgetItem, c'est son operator< qui serait utilisé.
+	EmployeeListItem(const QString& label, Employee* employee, EmployeeSortKeys keys, const EmployeeSortKey& sortKey);
+
+	Employee* getEmployee() const;
+	const EmployeeSortKeys& getKeys() const;
+	void setSalary(Cents salary);
+
+	bool operator<(const QListWidgetItem& other) const override;
+
+private:
+	Employee*              employee_;
+	EmployeeSortKeys       keys_;
+	// Le critère de la fenêtre : tous ses items changent de critère en même temps.
+	const EmployeeSortKey& sortKey_;
+};
+
+}